@@ -0,0 +1,365 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ParkourBenchmarkCommandlet.h"
+#include "ParkourFPSCharacter.h"
+#include "ParkourMovementComponent.h"
+#include "ParkourInputScript.h"
+#include "ParkourLog.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/GameModeBase.h"
+#include "GameFramework/PlayerStart.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+UParkourBenchmarkCommandlet::UParkourBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsServer = true;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+int32 UParkourBenchmarkCommandlet::Main(const FString& Params)
+{
+	FString MapName;
+
+	if (!FParse::Value(*Params, TEXT("map="), MapName))
+	{
+		UE_LOG(LogParkourMovement, Error, TEXT("Usage: -run=ParkourBenchmark -map=<package> [-counts=1,16,64,256] [-ticks=600] [-warmup=60] [-script=<file>] [-out=<results.csv>]"));
+		return 2;
+	}
+
+	FString CountsParam = TEXT("1,16,64,256");
+	FParse::Value(*Params, TEXT("counts="), CountsParam, false);
+
+	TArray<FString> CountStrings;
+	CountsParam.ParseIntoArray(CountStrings, TEXT(","));
+
+	int32 Ticks = 600;
+	FParse::Value(*Params, TEXT("ticks="), Ticks);
+
+	int32 WarmupTicks = 60;
+	FParse::Value(*Params, TEXT("warmup="), WarmupTicks);
+
+	FParkourInputScript Script = FParkourInputScript::MakeDefaultCourse();
+	FString ScriptPath;
+
+	if (FParse::Value(*Params, TEXT("script="), ScriptPath) && !Script.LoadFromFile(ScriptPath))
+	{
+		UE_LOG(LogParkourMovement, Error, TEXT("Could not read input script %s"), *ScriptPath);
+		return 2;
+	}
+
+	FString ResultsPath = FPaths::ProfilingDir() / TEXT("ParkourBenchmark") / FString::Printf(TEXT("Benchmark_%s.csv"), *FDateTime::Now().ToString());
+	FParse::Value(*Params, TEXT("out="), ResultsPath);
+
+	TArray<uint8> ScriptedModes;
+	Script.GetScriptedModes(ScriptedModes);
+
+	FMoveBudget DefaultBudget;
+	TMap<FString, FMoveBudget> ModeBudgets;
+	ParseBudgets(Params, DefaultBudget, ModeBudgets);
+
+	UWorld* World = LoadBenchmarkWorld(MapName);
+
+	if (World == nullptr)
+	{
+		UE_LOG(LogParkourMovement, Error, TEXT("Could not load benchmark map %s"), *MapName);
+		return 2;
+	}
+
+	FString Results = TEXT("Characters,Ticks,MovementMsPerTick,MovementMsPerCharacter,WorldMsPerTick") LINE_TERMINATOR;
+	int32 BudgetFailures = 0;
+
+	for (const FString& CountString : CountStrings)
+	{
+		const int32 Count = FCString::Atoi(*CountString);
+
+		if (Count <= 0)
+		{
+			continue;
+		}
+
+		TArray<AParkourFPSCharacter*> Characters;
+		SpawnCharacters(World, Count, Characters);
+
+		for (int32 Tick = 0; Tick < WarmupTicks; Tick++)
+		{
+			TickWorld(World, Characters, Script, Tick);
+		}
+
+		for (AParkourFPSCharacter* Character : Characters)
+		{
+			Character->GetParkourMovementComponent()->ResetTickCycles();
+		}
+
+		const double StartTime = FPlatformTime::Seconds();
+
+		for (int32 Tick = 0; Tick < Ticks; Tick++)
+		{
+			TickWorld(World, Characters, Script, WarmupTicks + Tick);
+		}
+
+		const double WorldMsPerTick = (FPlatformTime::Seconds() - StartTime) * 1000.0 / FMath::Max(Ticks, 1);
+
+		// each component ticks once per world tick, so the per character averages sum to the movement cost of one world tick
+		double MovementMsPerTick = 0.0;
+
+		for (AParkourFPSCharacter* Character : Characters)
+		{
+			MovementMsPerTick += Character->GetParkourMovementComponent()->GetAverageTickMs();
+		}
+
+		const double MovementMsPerCharacter = MovementMsPerTick / FMath::Max(Characters.Num(), 1);
+
+		UE_LOG(LogParkourMovement, Display, TEXT("%4d characters: movement %.3f ms/tick (%.4f ms/character), world %.3f ms/tick"), Characters.Num(), MovementMsPerTick,
+			MovementMsPerCharacter, WorldMsPerTick);
+
+		Results += FString::Printf(TEXT("%d,%d,%.4f,%.5f,%.4f"), Characters.Num(), Ticks, MovementMsPerTick, MovementMsPerCharacter, WorldMsPerTick);
+		Results += LINE_TERMINATOR;
+
+		BudgetFailures += CheckBudgets(Characters, ScriptedModes, DefaultBudget, ModeBudgets);
+
+		DestroyCharacters(Characters);
+	}
+
+	UnloadBenchmarkWorld(World);
+
+	if (!FFileHelper::SaveStringToFile(Results, *ResultsPath))
+	{
+		UE_LOG(LogParkourMovement, Error, TEXT("Failed to write benchmark results to %s"), *ResultsPath);
+		return 2;
+	}
+
+	UE_LOG(LogParkourMovement, Display, TEXT("Wrote benchmark results to %s"), *ResultsPath);
+
+	return BudgetFailures > 0 ? 1 : 0;
+}
+
+void UParkourBenchmarkCommandlet::ParseBudgets(const FString& Params, FMoveBudget& OutDefaultBudget, TMap<FString, FMoveBudget>& OutModeBudgets)
+{
+	FParse::Value(*Params, TEXT("querybudget="), OutDefaultBudget.MaxSceneQueries);
+	FParse::Value(*Params, TEXT("msbudget="), OutDefaultBudget.MaxMsPerTick);
+
+	FString BudgetsParam;
+
+	if (!FParse::Value(*Params, TEXT("budgets="), BudgetsParam, false))
+	{
+		return;
+	}
+
+	TArray<FString> Entries;
+	BudgetsParam.ParseIntoArray(Entries, TEXT(","));
+
+	for (const FString& Entry : Entries)
+	{
+		FString ModeName, Budget;
+
+		if (!Entry.Split(TEXT("="), &ModeName, &Budget))
+		{
+			continue;
+		}
+
+		FString Queries, Ms;
+		FMoveBudget& ModeBudget = OutModeBudgets.Add(ModeName, OutDefaultBudget);
+
+		if (Budget.Split(TEXT("/"), &Queries, &Ms))
+		{
+			ModeBudget.MaxSceneQueries = FCString::Atoi(*Queries);
+			ModeBudget.MaxMsPerTick = FCString::Atof(*Ms);
+		}
+		else
+		{
+			ModeBudget.MaxSceneQueries = FCString::Atoi(*Budget);
+		}
+	}
+}
+
+int32 UParkourBenchmarkCommandlet::CheckBudgets(const TArray<AParkourFPSCharacter*>& Characters, const TArray<uint8>& ScriptedModes, const FMoveBudget& DefaultBudget,
+	const TMap<FString, FMoveBudget>& ModeBudgets)
+{
+	TArray<FParkourModeTickCost> Totals;
+	Totals.SetNum(CMOVE_MAX + 1);
+
+	for (AParkourFPSCharacter* Character : Characters)
+	{
+		const TArray<FParkourModeTickCost>& ModeTickCosts = Character->GetParkourMovementComponent()->GetModeTickCosts();
+
+		for (int32 i = 0; i < ModeTickCosts.Num(); i++)
+		{
+			Totals[i].Ticks += ModeTickCosts[i].Ticks;
+			Totals[i].Cycles += ModeTickCosts[i].Cycles;
+			Totals[i].MaxSceneQueries = FMath::Max(Totals[i].MaxSceneQueries, ModeTickCosts[i].MaxSceneQueries);
+		}
+	}
+
+	const UEnum* CustomModeEnum = StaticEnum<ECustomMovementMode>();
+	int32 Failures = 0;
+
+	for (int32 i = 0; i < Totals.Num(); i++)
+	{
+		FString ModeName = i < CMOVE_MAX ? CustomModeEnum->GetNameStringByValue(i) : TEXT("None");
+		ModeName.RemoveFromStart(TEXT("CMOVE_"));
+
+		if (Totals[i].Ticks == 0)
+		{
+			// A mode the script drives but no character reached means the course or a mode entry check is broken, not that it is cheap
+			if (ScriptedModes.Contains(i))
+			{
+				UE_LOG(LogParkourMovement, Error, TEXT("%s is scripted but was never entered"), *ModeName);
+				Failures++;
+			}
+
+			continue;
+		}
+
+		const FMoveBudget* ModeBudget = ModeBudgets.Find(ModeName);
+		const FMoveBudget& Budget = ModeBudget ? *ModeBudget : DefaultBudget;
+		const double MsPerTick = FPlatformTime::ToMilliseconds64(Totals[i].Cycles) / Totals[i].Ticks;
+
+		// Scene query counts are deterministic for a given course and script, so they are the gate. Timings depend on the machine
+		// running the benchmark and are only reported.
+		if (Totals[i].MaxSceneQueries > Budget.MaxSceneQueries)
+		{
+			UE_LOG(LogParkourMovement, Error, TEXT("%s over budget: %d scene queries (budget %d)"), *ModeName, Totals[i].MaxSceneQueries, Budget.MaxSceneQueries);
+			Failures++;
+		}
+
+		if (MsPerTick > Budget.MaxMsPerTick)
+		{
+			UE_LOG(LogParkourMovement, Warning, TEXT("%s over time budget: %.4f ms/tick (budget %.4f)"), *ModeName, MsPerTick, Budget.MaxMsPerTick);
+		}
+
+		UE_LOG(LogParkourMovement, Display, TEXT("%s: %d scene queries, %.4f ms/tick over %d ticks"), *ModeName, Totals[i].MaxSceneQueries, MsPerTick, Totals[i].Ticks);
+	}
+
+	return Failures;
+}
+
+UWorld* UParkourBenchmarkCommandlet::LoadBenchmarkWorld(const FString& MapName)
+{
+	UPackage* MapPackage = LoadPackage(nullptr, *MapName, LOAD_None);
+	UWorld* World = MapPackage ? UWorld::FindWorldInPackage(MapPackage) : nullptr;
+
+	if (World == nullptr)
+	{
+		return nullptr;
+	}
+
+	World->AddToRoot();
+	World->WorldType = EWorldType::Game;
+	World->InitWorld();
+
+	BeginBenchmarkWorld(World);
+
+	return World;
+}
+
+UWorld* UParkourBenchmarkCommandlet::CreateBenchmarkWorld(FName WorldName)
+{
+	// Rooted and initialised by CreateWorld
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false, WorldName);
+
+	BeginBenchmarkWorld(World);
+
+	return World;
+}
+
+void UParkourBenchmarkCommandlet::BeginBenchmarkWorld(UWorld* World)
+{
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+
+	const FURL URL;
+	World->SetGameMode(URL);
+	World->InitializeActorsForPlay(URL);
+	World->BeginPlay();
+}
+
+void UParkourBenchmarkCommandlet::UnloadBenchmarkWorld(UWorld* World)
+{
+	World->EndPlay(EEndPlayReason::Quit);
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+	World->RemoveFromRoot();
+}
+
+UClass* UParkourBenchmarkCommandlet::GetCharacterClass(UWorld* World)
+{
+	AGameModeBase* GameMode = World->GetAuthGameMode();
+
+	if (GameMode && GameMode->DefaultPawnClass && GameMode->DefaultPawnClass->IsChildOf(AParkourFPSCharacter::StaticClass()))
+	{
+		return GameMode->DefaultPawnClass;
+	}
+
+	return AParkourFPSCharacter::StaticClass();
+}
+
+void UParkourBenchmarkCommandlet::SpawnCharacters(UWorld* World, int32 Count, TArray<AParkourFPSCharacter*>& OutCharacters)
+{
+	UClass* CharacterClass = GetCharacterClass(World);
+
+	TArray<FTransform> SpawnPoints;
+
+	for (TActorIterator<APlayerStart> It(World); It; ++It)
+	{
+		SpawnPoints.Add(It->GetActorTransform());
+	}
+
+	if (SpawnPoints.Num() == 0)
+	{
+		SpawnPoints.Add(FTransform(FVector(0.f, 0.f, 200.f)));
+	}
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	// characters sharing a spawn point are laid out on a grid behind it
+	const float GridSpacing = 150.f;
+
+	for (int32 i = 0; i < Count; i++)
+	{
+		FTransform SpawnTransform = SpawnPoints[i % SpawnPoints.Num()];
+		const int32 GridIndex = i / SpawnPoints.Num();
+		const FVector GridOffset((GridIndex / 16) * -GridSpacing, ((GridIndex % 16) - 8) * GridSpacing, 0.f);
+
+		SpawnTransform.AddToTranslation(SpawnTransform.TransformVectorNoScale(GridOffset));
+
+		AParkourFPSCharacter* Character = World->SpawnActor<AParkourFPSCharacter>(CharacterClass, SpawnTransform, SpawnParams);
+
+		if (Character)
+		{
+			Character->SpawnDefaultController();
+			OutCharacters.Add(Character);
+		}
+	}
+}
+
+void UParkourBenchmarkCommandlet::DestroyCharacters(TArray<AParkourFPSCharacter*>& Characters)
+{
+	for (AParkourFPSCharacter* Character : Characters)
+	{
+		if (AController* Controller = Character->GetController())
+		{
+			Controller->Destroy();
+		}
+
+		Character->Destroy();
+	}
+
+	Characters.Reset();
+}
+
+void UParkourBenchmarkCommandlet::TickWorld(UWorld* World, const TArray<AParkourFPSCharacter*>& Characters, const FParkourInputScript& Script, int32 Tick)
+{
+	for (AParkourFPSCharacter* Character : Characters)
+	{
+		Script.Apply(Character, Tick, TickDeltaTime);
+	}
+
+	World->Tick(LEVELTICK_All, TickDeltaTime);
+}
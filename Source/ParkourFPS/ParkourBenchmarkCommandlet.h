@@ -0,0 +1,69 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "ParkourBenchmarkCommandlet.generated.h"
+
+class AParkourFPSCharacter;
+class FParkourInputScript;
+
+/**
+ * Headless movement benchmark. Loads a course map, spawns N AI controlled parkour characters driven by an FParkourInputScript
+ * and ticks the world at a fixed rate, reporting milliseconds per tick spent in UParkourMovementComponent for each N.
+ *
+ * UE4Editor-Cmd ParkourFPS -run=ParkourBenchmark -nullrhi -map=<package> [-counts=1,16,64,256] [-ticks=600] [-warmup=60]
+ *     [-script=<file>] [-out=<results.csv>] [-querybudget=16] [-msbudget=0.1] [-budgets=WallRunning=10/0.05,Sliding=6/0.03]
+ *
+ * Each movement mode is also checked against a budget on the worst case scene queries in one tick and the average milliseconds per
+ * character tick. The commandlet returns 1 if any mode is over its scene query budget or a mode the script drives is never entered, so it
+ * can run unattended to catch e.g. a new probe in OnMovementUpdated. Modes over the milliseconds budget are only logged as warnings.
+ */
+UCLASS()
+class PARKOURFPS_API UParkourBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UParkourBenchmarkCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+
+	static constexpr float TickDeltaTime = 1.f / 60.f;
+
+	// Default budget of every mode, also checked by the movement automation tests
+	struct FMoveBudget
+	{
+		int32 MaxSceneQueries = 16;
+		float MaxMsPerTick = 0.1f;
+	};
+
+	// Loads a map as a standalone game world, also used by the ParkourReplay commandlet
+	static UWorld* LoadBenchmarkWorld(const FString& MapName);
+
+	// Creates an empty standalone game world, the movement automation tests build their courses in one
+	static UWorld* CreateBenchmarkWorld(FName WorldName);
+
+	static void UnloadBenchmarkWorld(UWorld* World);
+
+	// The game mode's pawn if it is a parkour character, so blueprint configured meshes and movement values are used too
+	static UClass* GetCharacterClass(UWorld* World);
+
+protected:
+	// Registers the world with the engine and begins play in it
+	static void BeginBenchmarkWorld(UWorld* World);
+
+	// Mode name (ECustomMovementMode without the prefix, or "None") to budget
+	static void ParseBudgets(const FString& Params, FMoveBudget& OutDefaultBudget, TMap<FString, FMoveBudget>& OutModeBudgets);
+
+	// Returns the number of modes that were over their scene query budget or scripted but never entered
+	static int32 CheckBudgets(const TArray<AParkourFPSCharacter*>& Characters, const TArray<uint8>& ScriptedModes, const FMoveBudget& DefaultBudget,
+		const TMap<FString, FMoveBudget>& ModeBudgets);
+
+	static void SpawnCharacters(UWorld* World, int32 Count, TArray<AParkourFPSCharacter*>& OutCharacters);
+
+	static void DestroyCharacters(TArray<AParkourFPSCharacter*>& Characters);
+
+	static void TickWorld(UWorld* World, const TArray<AParkourFPSCharacter*>& Characters, const FParkourInputScript& Script, int32 Tick);
+};
@@ -0,0 +1,208 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ParkourCorrectionAnalytics.h"
+#include "ParkourMovementComponent.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+
+CSV_DEFINE_CATEGORY(ParkourCorrections, true);
+
+namespace
+{
+	const float PositionErrorBucketEdges[FParkourCorrectionAnalytics::NumHistogramBuckets - 1] = { 1.f, 2.f, 5.f, 10.f, 25.f, 50.f, 100.f };
+	const float VelocityErrorBucketEdges[FParkourCorrectionAnalytics::NumHistogramBuckets - 1] = { 5.f, 10.f, 25.f, 50.f, 100.f, 250.f, 500.f };
+
+	float ParkourCorrectionStatsExportInterval = 0.f;
+	FAutoConsoleVariableRef CVarParkourCorrectionStatsExportInterval(
+		TEXT("p.Parkour.CorrectionStats.ExportInterval"),
+		ParkourCorrectionStatsExportInterval,
+		TEXT("Seconds between correction statistic exports to Saved/Profiling/ParkourCorrections. 0 disables periodic export."));
+}
+
+FParkourCorrectionAnalytics& FParkourCorrectionAnalytics::Get()
+{
+	static FParkourCorrectionAnalytics Instance;
+	return Instance;
+}
+
+FParkourCorrectionAnalytics::FParkourCorrectionAnalytics()
+{
+	const UEnum* CustomModeEnum = StaticEnum<ECustomMovementMode>();
+
+	Buckets.SetNum(CMOVE_MAX + 1);
+	BucketNames.SetNum(CMOVE_MAX + 1);
+
+	for (int32 i = 0; i < CMOVE_MAX; i++)
+	{
+		BucketNames[i] = CustomModeEnum->GetNameStringByValue(i);
+	}
+
+	BucketNames[CMOVE_MAX] = TEXT("None");
+
+	for (int32 i = 0; i < Buckets.Num(); i++)
+	{
+		Buckets[i].CsvStatName = FName(*FString::Printf(TEXT("Corrections_%s"), *BucketNames[i]));
+	}
+
+	StartTime = FPlatformTime::Seconds();
+	LastExportTime = StartTime;
+	PeriodicExportFilename = FPaths::ProfilingDir() / TEXT("ParkourCorrections") / FString::Printf(TEXT("CorrectionStats_%s.csv"), *FDateTime::Now().ToString());
+
+	TickerHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FParkourCorrectionAnalytics::Tick), 1.f);
+}
+
+FParkourCorrectionAnalytics::~FParkourCorrectionAnalytics()
+{
+	FTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+}
+
+void FParkourCorrectionAnalytics::RecordCorrection(uint8 MovementMode, uint8 CustomMovementMode, float PositionError, float VelocityError, int32 ReplayedMoves)
+{
+	const int32 BucketIndex = (MovementMode == MOVE_Custom && CustomMovementMode < CMOVE_MAX) ? CustomMovementMode : CMOVE_MAX;
+	FModeBucket& Bucket = Buckets[BucketIndex];
+
+	Bucket.Corrections++;
+	Bucket.ReplayedMoves += ReplayedMoves;
+	Bucket.PositionErrorSum += PositionError;
+	Bucket.VelocityErrorSum += VelocityError;
+	Bucket.PositionErrorHistogram[GetHistogramBucket(PositionErrorBucketEdges, PositionError)]++;
+	Bucket.VelocityErrorHistogram[GetHistogramBucket(VelocityErrorBucketEdges, VelocityError)]++;
+
+#if CSV_PROFILER
+	FCsvProfiler::RecordCustomStat(Bucket.CsvStatName, CSV_CATEGORY_INDEX(ParkourCorrections), 1, ECsvCustomStatOp::Accumulate);
+#endif
+	CSV_CUSTOM_STAT(ParkourCorrections, ReplayedMoves, ReplayedMoves, ECsvCustomStatOp::Accumulate);
+}
+
+int32 FParkourCorrectionAnalytics::GetHistogramBucket(const float* BucketEdges, float Error)
+{
+	for (int32 i = 0; i < NumHistogramBuckets - 1; i++)
+	{
+		if (Error < BucketEdges[i])
+		{
+			return i;
+		}
+	}
+
+	return NumHistogramBuckets - 1;
+}
+
+bool FParkourCorrectionAnalytics::ExportToCsv(const FString& Filename) const
+{
+	FString Csv;
+
+	if (!FPaths::FileExists(Filename))
+	{
+		Csv += TEXT("Time,Mode,Corrections,CorrectionsPerMinute,ReplayedMoves,AvgPositionError,AvgVelocityError");
+
+		for (int32 i = 0; i < NumHistogramBuckets; i++)
+		{
+			Csv += i < NumHistogramBuckets - 1 ? FString::Printf(TEXT(",PositionError<%g"), PositionErrorBucketEdges[i]) : TEXT(",PositionError>=Max");
+		}
+
+		for (int32 i = 0; i < NumHistogramBuckets; i++)
+		{
+			Csv += i < NumHistogramBuckets - 1 ? FString::Printf(TEXT(",VelocityError<%g"), VelocityErrorBucketEdges[i]) : TEXT(",VelocityError>=Max");
+		}
+
+		Csv += LINE_TERMINATOR;
+	}
+
+	const double Now = FPlatformTime::Seconds();
+	const double ElapsedMinutes = FMath::Max((Now - StartTime) / 60.0, 1.0 / 60.0);
+
+	for (int32 BucketIndex = 0; BucketIndex < Buckets.Num(); BucketIndex++)
+	{
+		const FModeBucket& Bucket = Buckets[BucketIndex];
+		const double Count = FMath::Max(Bucket.Corrections, 1);
+
+		Csv += FString::Printf(TEXT("%.1f,%s,%d,%.2f,%d,%.2f,%.2f"), Now - StartTime, *BucketNames[BucketIndex], Bucket.Corrections, Bucket.Corrections / ElapsedMinutes,
+			Bucket.ReplayedMoves, Bucket.PositionErrorSum / Count, Bucket.VelocityErrorSum / Count);
+
+		for (int32 i = 0; i < NumHistogramBuckets; i++)
+		{
+			Csv += FString::Printf(TEXT(",%d"), Bucket.PositionErrorHistogram[i]);
+		}
+
+		for (int32 i = 0; i < NumHistogramBuckets; i++)
+		{
+			Csv += FString::Printf(TEXT(",%d"), Bucket.VelocityErrorHistogram[i]);
+		}
+
+		Csv += LINE_TERMINATOR;
+	}
+
+	return FFileHelper::SaveStringToFile(Csv, *Filename, FFileHelper::EEncodingOptions::AutoDetect, &IFileManager::Get(), FILEWRITE_Append);
+}
+
+void FParkourCorrectionAnalytics::Reset()
+{
+	for (FModeBucket& Bucket : Buckets)
+	{
+		const FName CsvStatName = Bucket.CsvStatName;
+
+		Bucket = FModeBucket();
+		Bucket.CsvStatName = CsvStatName;
+	}
+
+	StartTime = FPlatformTime::Seconds();
+}
+
+int32 FParkourCorrectionAnalytics::GetTotalCorrections() const
+{
+	int32 Total = 0;
+
+	for (const FModeBucket& Bucket : Buckets)
+	{
+		Total += Bucket.Corrections;
+	}
+
+	return Total;
+}
+
+double FParkourCorrectionAnalytics::GetCorrectionsPerMinute() const
+{
+	const double ElapsedMinutes = FMath::Max((FPlatformTime::Seconds() - StartTime) / 60.0, 1.0 / 60.0);
+
+	return GetTotalCorrections() / ElapsedMinutes;
+}
+
+bool FParkourCorrectionAnalytics::Tick(float DeltaTime)
+{
+	if (ParkourCorrectionStatsExportInterval > 0.f)
+	{
+		const double Now = FPlatformTime::Seconds();
+
+		if (Now - LastExportTime >= ParkourCorrectionStatsExportInterval)
+		{
+			LastExportTime = Now;
+			ExportToCsv(PeriodicExportFilename);
+		}
+	}
+
+	return true;
+}
+
+static FAutoConsoleCommand ExportParkourCorrectionStatsCommand(
+	TEXT("p.Parkour.CorrectionStats.Export"),
+	TEXT("Appends the correction statistics per movement mode to a CSV file. Optional argument: file name."),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		const FString Filename = Args.Num() > 0 ? Args[0] : FPaths::ProfilingDir() / TEXT("ParkourCorrections") / TEXT("CorrectionStats.csv");
+
+		if (FParkourCorrectionAnalytics::Get().ExportToCsv(Filename))
+		{
+			UE_LOG(LogMovementCorrections, Display, TEXT("Wrote correction statistics to %s"), *Filename);
+		}
+	}));
+
+static FAutoConsoleCommand ResetParkourCorrectionStatsCommand(
+	TEXT("p.Parkour.CorrectionStats.Reset"),
+	TEXT("Clears the aggregated correction statistics."),
+	FConsoleCommandDelegate::CreateLambda([]()
+	{
+		FParkourCorrectionAnalytics::Get().Reset();
+	}));
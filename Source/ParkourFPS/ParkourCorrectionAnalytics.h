@@ -0,0 +1,60 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+
+// Movement correction statistics aggregated over every parkour character in the process and bucketed by custom
+// movement mode. Exported as CSV, periodically with p.Parkour.CorrectionStats.ExportInterval or on demand with
+// p.Parkour.CorrectionStats.Export, and as ParkourCorrections stats in the CSV profiler.
+class PARKOURFPS_API FParkourCorrectionAnalytics
+{
+public:
+	// Upper edges of the error histogram buckets in cm (position) and cm/s (velocity). The last bucket is open ended.
+	static constexpr int32 NumHistogramBuckets = 8;
+
+	static FParkourCorrectionAnalytics& Get();
+
+	FParkourCorrectionAnalytics();
+	~FParkourCorrectionAnalytics();
+
+	void RecordCorrection(uint8 MovementMode, uint8 CustomMovementMode, float PositionError, float VelocityError, int32 ReplayedMoves);
+
+	// Appends one row per mode bucket to a CSV file, writing the header first if the file is new
+	bool ExportToCsv(const FString& Filename) const;
+
+	void Reset();
+
+	int32 GetTotalCorrections() const;
+	double GetCorrectionsPerMinute() const;
+
+private:
+	struct FModeBucket
+	{
+		int32 Corrections = 0;
+		int32 ReplayedMoves = 0;
+
+		double PositionErrorSum = 0.0;
+		double VelocityErrorSum = 0.0;
+
+		int32 PositionErrorHistogram[NumHistogramBuckets] = {};
+		int32 VelocityErrorHistogram[NumHistogramBuckets] = {};
+
+		FName CsvStatName;
+	};
+
+	static int32 GetHistogramBucket(const float* BucketEdges, float Error);
+
+	bool Tick(float DeltaTime);
+
+	// Indexed by ECustomMovementMode, the last bucket collects corrections outside of custom movement modes
+	TArray<FModeBucket> Buckets;
+	TArray<FString> BucketNames;
+
+	double StartTime;
+	double LastExportTime;
+	FString PeriodicExportFilename;
+
+	FDelegateHandle TickerHandle;
+};
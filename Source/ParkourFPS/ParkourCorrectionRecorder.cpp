@@ -0,0 +1,95 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ParkourCorrectionRecorder.h"
+#include "HAL/FileManager.h"
+#include "Serialization/Archive.h"
+
+namespace
+{
+	// "PKCR"
+	constexpr uint32 CorrectionFileMagic = 0x524B4350;
+}
+
+FParkourCorrectionRecorder::FParkourCorrectionRecorder()
+	: NextRecord(0)
+	, NumRecords(0)
+	, NextInput(0)
+	, NumInputs(0)
+{
+	FMemory::Memzero(InputHistory);
+}
+
+void FParkourCorrectionRecorder::RecordInputFlags(uint16 Flags)
+{
+	InputHistory[NextInput] = Flags;
+
+	NextInput = (NextInput + 1) % FParkourCorrectionRecord::InputHistoryLength;
+	NumInputs = FMath::Min(NumInputs + 1, FParkourCorrectionRecord::InputHistoryLength);
+}
+
+void FParkourCorrectionRecorder::RecordCorrection(const FParkourCorrectionRecord& Record)
+{
+	FParkourCorrectionRecord& NewRecord = Records[NextRecord];
+	NewRecord = Record;
+
+	// Copy the input history out of its ring buffer so the record reads oldest to newest
+	const int32 FirstInput = (NextInput - NumInputs + FParkourCorrectionRecord::InputHistoryLength) % FParkourCorrectionRecord::InputHistoryLength;
+
+	for (int32 i = 0; i < NumInputs; i++)
+	{
+		NewRecord.InputFlags[i] = InputHistory[(FirstInput + i) % FParkourCorrectionRecord::InputHistoryLength];
+	}
+
+	NewRecord.NumInputFlags = static_cast<uint8>(NumInputs);
+
+	NextRecord = (NextRecord + 1) % MaxRecords;
+	NumRecords = FMath::Min(NumRecords + 1, MaxRecords);
+}
+
+bool FParkourCorrectionRecorder::DumpToFile(const FString& Filename) const
+{
+	TUniquePtr<FArchive> Ar(IFileManager::Get().CreateFileWriter(*Filename));
+
+	if (!Ar)
+	{
+		return false;
+	}
+
+	uint32 Magic = CorrectionFileMagic;
+	uint32 Version = FileVersion;
+	int32 RecordCount = NumRecords;
+	int32 InputHistoryLength = FParkourCorrectionRecord::InputHistoryLength;
+
+	*Ar << Magic;
+	*Ar << Version;
+	*Ar << RecordCount;
+	*Ar << InputHistoryLength;
+
+	const int32 FirstRecord = (NextRecord - NumRecords + MaxRecords) % MaxRecords;
+
+	for (int32 i = 0; i < NumRecords; i++)
+	{
+		// Copy so the const buffer can go through the bidirectional FArchive operators
+		FParkourCorrectionRecord Record = Records[(FirstRecord + i) % MaxRecords];
+
+		*Ar << Record.Timestamp;
+		*Ar << Record.MoveTimeStamp;
+		*Ar << Record.ClientLocation;
+		*Ar << Record.ServerLocation;
+		*Ar << Record.ClientVelocity;
+		*Ar << Record.ServerVelocity;
+		*Ar << Record.MovementMode;
+		*Ar << Record.CustomMovementMode;
+		*Ar << Record.ServerMovementMode;
+		*Ar << Record.NumInputFlags;
+
+		for (int32 j = 0; j < FParkourCorrectionRecord::InputHistoryLength; j++)
+		{
+			uint16 Flags = j < Record.NumInputFlags ? Record.InputFlags[j] : 0;
+			*Ar << Flags;
+		}
+	}
+
+	return Ar->Close();
+}
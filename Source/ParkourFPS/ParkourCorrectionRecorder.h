@@ -0,0 +1,63 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// One movement correction. Stored as plain binary so recording a correction is a copy, not a log line.
+struct FParkourCorrectionRecord
+{
+	static constexpr int32 InputHistoryLength = 8;
+
+	// FPlatformTime::Seconds() when the correction was recorded
+	double Timestamp = 0.0;
+
+	// Time stamp of the move that was corrected
+	float MoveTimeStamp = 0.f;
+
+	FVector ClientLocation = FVector::ZeroVector;
+	FVector ServerLocation = FVector::ZeroVector;
+	FVector ClientVelocity = FVector::ZeroVector;
+	FVector ServerVelocity = FVector::ZeroVector;
+
+	uint8 MovementMode = 0;
+	uint8 CustomMovementMode = 0;
+	uint8 ServerMovementMode = 0;
+
+	// Parkour input flags of the most recent ticks, oldest first
+	uint8 NumInputFlags = 0;
+	uint16 InputFlags[InputHistoryLength] = {};
+};
+
+// Fixed size ring buffer of the most recent corrections for a single character.
+// Nothing is allocated after construction, dump it to disk with "p.Parkour.DumpCorrections".
+class PARKOURFPS_API FParkourCorrectionRecorder
+{
+public:
+	static constexpr int32 MaxRecords = 64;
+
+	// Version of the file written by DumpToFile, bump whenever the record layout changes
+	static constexpr uint32 FileVersion = 2;
+
+	FParkourCorrectionRecorder();
+
+	// Remembers the parkour input flags of the current tick
+	void RecordInputFlags(uint16 Flags);
+
+	// Stores a correction, overwriting the oldest one when the buffer is full. The input history is filled in here.
+	void RecordCorrection(const FParkourCorrectionRecord& Record);
+
+	int32 Num() const { return NumRecords; }
+
+	// Writes all records, oldest first, to a binary file
+	bool DumpToFile(const FString& Filename) const;
+
+private:
+	FParkourCorrectionRecord Records[MaxRecords];
+	int32 NextRecord;
+	int32 NumRecords;
+
+	uint16 InputHistory[FParkourCorrectionRecord::InputHistoryLength];
+	int32 NextInput;
+	int32 NumInputs;
+};
@@ -1,7 +1,21 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "ParkourFPS.h"
+#include "ParkourSoakAgent.h"
 #include "Modules/ModuleManager.h"
 
-IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, ParkourFPS, "ParkourFPS" );
- 
\ No newline at end of file
+class FParkourFPSModule : public FDefaultGameModuleImpl
+{
+public:
+	virtual void StartupModule() override
+	{
+		FParkourSoakAgent::StartFromCommandLine();
+	}
+
+	virtual void ShutdownModule() override
+	{
+		FParkourSoakAgent::Stop();
+	}
+};
+
+IMPLEMENT_PRIMARY_GAME_MODULE( FParkourFPSModule, ParkourFPS, "ParkourFPS" );
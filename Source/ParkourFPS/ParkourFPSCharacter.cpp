@@ -9,6 +9,10 @@
 #include "GameFramework/Controller.h"
 #include "GameFramework/SpringArmComponent.h"
 #include "ParkourMovementComponent.h"
+#include "ParkourQuantize.h"
+#include "Net/UnrealNetwork.h"
+#include "GameFramework/PlayerController.h"
+#include "TimerManager.h"
 
 //////////////////////////////////////////////////////////////////////////
 // AParkourFPSCharacter
@@ -155,6 +159,143 @@ UParkourMovementComponent* AParkourFPSCharacter::GetParkourMovementComponent() c
 	return static_cast<UParkourMovementComponent*>(GetCharacterMovement());
 }
 
+void AParkourFPSCharacter::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	// The owning client predicts its own parkour state
+	DOREPLIFETIME_CONDITION(AParkourFPSCharacter, ParkourState, COND_SimulatedOnly);
+	DOREPLIFETIME_CONDITION(AParkourFPSCharacter, RailState, COND_SimulatedOnly);
+}
+
+void AParkourFPSCharacter::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (HasAuthority())
+	{
+		ConfiguredNetUpdateFrequency = NetUpdateFrequency;
+		ConfiguredMinNetUpdateFrequency = MinNetUpdateFrequency;
+
+		GetWorldTimerManager().SetTimer(AdaptiveNetUpdateTimer, this, &AParkourFPSCharacter::UpdateAdaptiveNetUpdateFrequency, AdaptiveNetUpdateInterval, true);
+		UpdateAdaptiveNetUpdateFrequency();
+	}
+}
+
+float AParkourFPSCharacter::GetNetPriority(const FVector& ViewPos, const FVector& ViewDir, AActor* Viewer, AActor* ViewTarget, UActorChannel* InChannel, float Time, bool bLowBandwidth)
+{
+	// Super already weighs in distance and view direction, this adds how hard the current move is to follow
+	float Priority = Super::GetNetPriority(ViewPos, ViewDir, Viewer, ViewTarget, InChannel, Time, bLowBandwidth);
+
+	switch (GetParkourMovementComponent()->GetNetDynamics())
+	{
+	case EParkourNetDynamics::High:
+		Priority *= 1.5f;
+		break;
+	case EParkourNetDynamics::Predictable:
+		Priority *= 0.5f;
+		break;
+	default:
+		break;
+	}
+
+	return Priority;
+}
+
+void AParkourFPSCharacter::UpdateAdaptiveNetUpdateFrequency()
+{
+	// Mode changes while spawning come in before BeginPlay has saved the configured frequencies
+	if (!AdaptiveNetUpdateTimer.IsValid())
+	{
+		return;
+	}
+
+	float ModeFrequency = ConfiguredNetUpdateFrequency;
+
+	switch (GetParkourMovementComponent()->GetNetDynamics())
+	{
+	case EParkourNetDynamics::High:
+		ModeFrequency = HighDynamicsNetUpdateFrequency;
+		break;
+	case EParkourNetDynamics::Predictable:
+		ModeFrequency = PredictableNetUpdateFrequency;
+		break;
+	default:
+		break;
+	}
+
+	const float DistanceAlpha = FMath::GetRangePct(NearViewerDistance, FarViewerDistance, GetClosestViewerDistance());
+	const float DistanceScale = FMath::Lerp(1.f, FarViewerScale, FMath::Clamp(DistanceAlpha, 0.f, 1.f));
+
+	NetUpdateFrequency = FMath::Max(ModeFrequency * DistanceScale, MinAdaptiveNetUpdateFrequency);
+	MinNetUpdateFrequency = FMath::Min(ConfiguredMinNetUpdateFrequency, NetUpdateFrequency);
+}
+
+float AParkourFPSCharacter::GetClosestViewerDistance() const
+{
+	float ClosestDistanceSquared = MAX_flt;
+
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* PlayerController = It->Get();
+
+		if (PlayerController == nullptr || PlayerController == GetController())
+		{
+			continue;
+		}
+
+		FVector ViewLocation;
+		FRotator ViewRotation;
+		PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+
+		ClosestDistanceSquared = FMath::Min(ClosestDistanceSquared, FVector::DistSquared(ViewLocation, GetActorLocation()));
+	}
+
+	return ClosestDistanceSquared == MAX_flt ? 0.f : FMath::Sqrt(ClosestDistanceSquared);
+}
+
+FParkourReplicatedState AParkourFPSCharacter::GetParkourState() const
+{
+	return ParkourState;
+}
+
+FVector AParkourFPSCharacter::GetParkourStateNormal() const
+{
+	return ParkourQuantize::UnpackNormal16(ParkourState.PackedNormal);
+}
+
+void AParkourFPSCharacter::SetParkourState(const FParkourReplicatedState& NewState)
+{
+	ParkourState = NewState;
+}
+
+const FParkourRailState& AParkourFPSCharacter::GetRailState() const
+{
+	return RailState;
+}
+
+void AParkourFPSCharacter::SetRailState(const FParkourRailState& NewState)
+{
+	RailState = NewState;
+}
+
+void AParkourFPSCharacter::OnRep_ParkourState(const FParkourReplicatedState& PreviousState)
+{
+	GetParkourMovementComponent()->ApplyReplicatedParkourState(ParkourState);
+
+	OnParkourStateChanged(PreviousState);
+}
+
+bool FParkourReplicatedState::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	Ar << CustomMode;
+	Ar << Flags;
+	Ar << PackedNormal;
+
+	bOutSuccess = true;
+	return true;
+}
+
 void AParkourFPSCharacter::Jump()
 {
 	Super::Jump();
@@ -171,7 +312,8 @@ void AParkourFPSCharacter::StopJumping()
 
 void AParkourFPSCharacter::AllowYawInput(bool IsAllowed)
 {
-	if (IsLocallyControlled() == false)
+	// AI controlled characters (e.g. the benchmark bots) are locally controlled but have no input component
+	if (IsLocallyControlled() == false || InputComponent == nullptr)
 	{
 		return;
 	}
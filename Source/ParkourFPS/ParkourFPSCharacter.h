@@ -8,6 +8,80 @@
 
 class UParkourMovementComponent;
 
+/** Parkour state replicated to simulated proxies so they can pick poses and smoothing, packed into 4 bytes */
+USTRUCT(BlueprintType)
+struct FParkourReplicatedState
+{
+	GENERATED_BODY()
+
+	static constexpr uint8 Flag_InCustomMode = 1 << 0;
+	static constexpr uint8 Flag_WallOnRight = 1 << 1;
+
+	/** ECustomMovementMode, only meaningful while InCustomMode() */
+	UPROPERTY(BlueprintReadOnly, Category = "Movement")
+	uint8 CustomMode = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Movement")
+	uint8 Flags = 0;
+
+	/** Wall, ladder or ledge normal, or the zipline direction, packed with ParkourQuantize::PackNormal16 */
+	uint16 PackedNormal = 0;
+
+	bool InCustomMode() const { return (Flags & Flag_InCustomMode) != 0; }
+	bool IsWallOnRight() const { return (Flags & Flag_WallOnRight) != 0; }
+
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
+
+	bool operator==(const FParkourReplicatedState& Other) const
+	{
+		return CustomMode == Other.CustomMode && Flags == Other.Flags && PackedNormal == Other.PackedNormal;
+	}
+
+	bool operator!=(const FParkourReplicatedState& Other) const
+	{
+		return !(*this == Other);
+	}
+};
+
+/** Anchor for simulated proxies to extrapolate zipline and ladder motion analytically, refreshed by the server when the motion changes */
+USTRUCT()
+struct FParkourRailState
+{
+	GENERATED_BODY()
+
+	/** Zipline or ladder the character is on, null when not on a rail */
+	UPROPERTY()
+	AActor* Rail = nullptr;
+
+	UPROPERTY()
+	FVector_NetQuantize AnchorLocation;
+
+	/** Server world time the anchor was taken at */
+	UPROPERTY()
+	float AnchorServerTime = 0.f;
+
+	/** Speed and acceleration along the rail direction at the anchor */
+	UPROPERTY()
+	float AnchorSpeed = 0.f;
+
+	UPROPERTY()
+	float Acceleration = 0.f;
+
+	/** 0 for no limit */
+	UPROPERTY()
+	float MaxSpeed = 0.f;
+};
+
+template<>
+struct TStructOpsTypeTraits<FParkourReplicatedState> : public TStructOpsTypeTraitsBase2<FParkourReplicatedState>
+{
+	enum
+	{
+		WithNetSerializer = true,
+		WithIdenticalViaEquality = true,
+	};
+};
+
 UCLASS(config=Game, Blueprintable)
 class PARKOURFPS_API AParkourFPSCharacter : public ACharacter
 {
@@ -38,6 +112,28 @@ public:
 	virtual void Jump() override;
 	virtual void StopJumping() override;
 
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+	virtual float GetNetPriority(const FVector& ViewPos, const FVector& ViewDir, AActor* Viewer, AActor* ViewTarget, UActorChannel* InChannel, float Time, bool bLowBandwidth) override;
+
+	/** Picks the net update frequency from the current parkour mode and the distance to the closest viewer, server only */
+	void UpdateAdaptiveNetUpdateFrequency();
+
+	/** Returns the parkour state replicated to simulated proxies */
+	UFUNCTION(BlueprintPure, Category = "Movement")
+	FParkourReplicatedState GetParkourState() const;
+
+	/** Returns the normal packed in the replicated parkour state */
+	UFUNCTION(BlueprintPure, Category = "Movement")
+	FVector GetParkourStateNormal() const;
+
+	/** Called by the movement component on the server */
+	void SetParkourState(const FParkourReplicatedState& NewState);
+
+	const FParkourRailState& GetRailState() const;
+
+	/** Called by the movement component on the server */
+	void SetRailState(const FParkourRailState& NewState);
+
 protected:
 
 	/** Resets HMD orientation in VR. */
@@ -67,6 +163,54 @@ protected:
 	/** Handler for when a touch input stops. */
 	void TouchStopped(ETouchIndex::Type FingerIndex, FVector Location);
 
+protected:
+	virtual void BeginPlay() override;
+
+	/** Net update frequency while wall running, sliding, climbing or vaulting */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Network|Adaptive")
+	float HighDynamicsNetUpdateFrequency = 60.f;
+
+	/** Net update frequency on ziplines, ladders and ledges. Proxies extrapolate rail motion, so this can be very low. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Network|Adaptive")
+	float PredictableNetUpdateFrequency = 4.f;
+
+	/** Viewers closer than this get the full rate for the mode */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Network|Adaptive")
+	float NearViewerDistance = 1500.f;
+
+	/** Viewers further than this get the rate scaled by FarViewerScale */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Network|Adaptive")
+	float FarViewerDistance = 6000.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Network|Adaptive", meta = (ClampMin = "0", ClampMax = "1"))
+	float FarViewerScale = 0.25f;
+
+	/** Never replicate less often than this */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Network|Adaptive")
+	float MinAdaptiveNetUpdateFrequency = 2.f;
+
+	/** Seconds between distance based re-evaluations, mode changes re-evaluate immediately */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Network|Adaptive")
+	float AdaptiveNetUpdateInterval = 0.25f;
+
+	FTimerHandle AdaptiveNetUpdateTimer;
+
+	/** NetUpdateFrequency and MinNetUpdateFrequency the character was configured with, used on the ground and in the air */
+	float ConfiguredNetUpdateFrequency = 0.f;
+	float ConfiguredMinNetUpdateFrequency = 0.f;
+
+	/** Distance from this character to the closest other player's view point */
+	float GetClosestViewerDistance() const;
+
+	UPROPERTY(ReplicatedUsing = OnRep_ParkourState)
+	FParkourReplicatedState ParkourState;
+
+	UFUNCTION()
+	void OnRep_ParkourState(const FParkourReplicatedState& PreviousState);
+
+	UPROPERTY(Replicated)
+	FParkourRailState RailState;
+
 protected:
 	// APawn interface
 	virtual void SetupPlayerInputComponent(class UInputComponent* PlayerInputComponent) override;
@@ -141,5 +285,9 @@ public:
 
 	UFUNCTION(BlueprintImplementableEvent)
 	void PlayClimbMontage();
+
+	/** Called on simulated proxies when the replicated parkour state changes */
+	UFUNCTION(BlueprintImplementableEvent)
+	void OnParkourStateChanged(const FParkourReplicatedState& PreviousState);
 };
 
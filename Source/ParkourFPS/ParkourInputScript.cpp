@@ -0,0 +1,170 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ParkourInputScript.h"
+#include "ParkourFPSCharacter.h"
+#include "ParkourMovementComponent.h"
+#include "GameFramework/Controller.h"
+#include "Misc/FileHelper.h"
+
+FParkourInputScript FParkourInputScript::MakeDefaultCourse()
+{
+	FParkourInputScript Script;
+
+	auto AddStep = [&Script](int32 Ticks, float Forward, float YawRate, bool Key1, bool Key2, bool Key3, bool Jump, bool LadderUp)
+	{
+		FParkourScriptedInput Step;
+		Step.Ticks = Ticks;
+		Step.Forward = Forward;
+		Step.YawRate = YawRate;
+		Step.MovementKey1 = Key1;
+		Step.MovementKey2 = Key2;
+		Step.MovementKey3 = Key3;
+		Step.CustomJump = Jump;
+		Step.LadderUp = LadderUp;
+
+		Script.Steps.Add(Step);
+		Script.Length += Ticks;
+	};
+
+	// Ticks, Forward, YawRate, Key1 (wall run), Key2 (slide), Key3 (vertical wall run), Jump, LadderUp
+	AddStep(30, 1.f, 0.f, false, false, false, false, false);
+	AddStep(5, 1.f, 0.f, false, false, false, true, false);
+	AddStep(90, 1.f, 0.f, true, false, false, false, false);
+	AddStep(5, 1.f, 0.f, true, false, false, true, false);
+	AddStep(60, 1.f, 0.f, false, true, false, false, false);
+	AddStep(90, 1.f, 0.f, false, false, true, false, false);
+	AddStep(30, 0.f, 0.f, false, false, true, false, false);
+	AddStep(30, 1.f, 0.f, false, false, false, true, false);
+	AddStep(5, 1.f, 0.f, false, false, false, true, false);
+	AddStep(90, 1.f, 0.f, false, false, false, false, true);
+	AddStep(30, 1.f, 90.f, false, false, false, false, false);
+
+	return Script;
+}
+
+bool FParkourInputScript::LoadFromFile(const FString& Filename)
+{
+	TArray<FString> Lines;
+
+	if (!FFileHelper::LoadFileToStringArray(Lines, *Filename))
+	{
+		return false;
+	}
+
+	Steps.Reset();
+	Length = 0;
+
+	TArray<FString> Tokens;
+
+	for (FString Line : Lines)
+	{
+		int32 CommentStart;
+
+		if (Line.FindChar(TEXT('#'), CommentStart))
+		{
+			Line.LeftInline(CommentStart);
+		}
+
+		Line.ParseIntoArrayWS(Tokens);
+
+		if (Tokens.Num() < 3)
+		{
+			continue;
+		}
+
+		FParkourScriptedInput Step;
+		Step.Ticks = FMath::Max(FCString::Atoi(*Tokens[0]), 1);
+		Step.Forward = FCString::Atof(*Tokens[1]);
+		Step.YawRate = FCString::Atof(*Tokens[2]);
+		Step.MovementKey1 = Tokens.Num() > 3 && Tokens[3].ToBool();
+		Step.MovementKey2 = Tokens.Num() > 4 && Tokens[4].ToBool();
+		Step.MovementKey3 = Tokens.Num() > 5 && Tokens[5].ToBool();
+		Step.CustomJump = Tokens.Num() > 6 && Tokens[6].ToBool();
+		Step.LadderUp = Tokens.Num() > 7 && Tokens[7].ToBool();
+
+		Steps.Add(Step);
+		Length += Step.Ticks;
+	}
+
+	return Steps.Num() > 0;
+}
+
+int32 FParkourInputScript::GetLength() const
+{
+	return Length;
+}
+
+void FParkourInputScript::GetScriptedModes(TArray<uint8>& OutModes) const
+{
+	OutModes.AddUnique(CMOVE_MAX);
+
+	for (const FParkourScriptedInput& Step : Steps)
+	{
+		if (Step.MovementKey1)
+		{
+			OutModes.AddUnique(CMOVE_WallRunning);
+		}
+
+		if (Step.MovementKey2)
+		{
+			OutModes.AddUnique(CMOVE_Sliding);
+		}
+
+		if (Step.MovementKey3)
+		{
+			OutModes.AddUnique(CMOVE_VerticalWallRunning);
+		}
+
+		if (Step.LadderUp)
+		{
+			OutModes.AddUnique(CMOVE_ClimbLadder);
+		}
+	}
+}
+
+const FParkourScriptedInput& FParkourInputScript::GetStep(int32 Tick) const
+{
+	int32 ScriptTick = Tick % Length;
+
+	for (const FParkourScriptedInput& Step : Steps)
+	{
+		if (ScriptTick < Step.Ticks)
+		{
+			return Step;
+		}
+
+		ScriptTick -= Step.Ticks;
+	}
+
+	return Steps.Last();
+}
+
+void FParkourInputScript::Apply(AParkourFPSCharacter* Character, int32 Tick, float DeltaTime) const
+{
+	if (Character == nullptr || Steps.Num() == 0)
+	{
+		return;
+	}
+
+	const FParkourScriptedInput& Step = GetStep(Tick + Character->GetUniqueID());
+	UParkourMovementComponent* ParkourMovement = Character->GetParkourMovementComponent();
+
+	ParkourMovement->SetMovementKey1Down(Step.MovementKey1);
+	ParkourMovement->SetMovementKey2Down(Step.MovementKey2);
+	ParkourMovement->SetMovementKey3Down(Step.MovementKey3);
+	ParkourMovement->SetWantsToCustomJump(Step.CustomJump);
+	ParkourMovement->SetWantsToGoUpLadder(Step.LadderUp);
+
+	if (Step.YawRate != 0.f && Character->GetController())
+	{
+		FRotator ControlRotation = Character->GetController()->GetControlRotation();
+		ControlRotation.Yaw += Step.YawRate * DeltaTime;
+		Character->GetController()->SetControlRotation(ControlRotation);
+	}
+
+	if (Step.Forward != 0.f)
+	{
+		Character->AddMovementInput(Character->GetActorForwardVector(), Step.Forward);
+	}
+}
@@ -0,0 +1,47 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class AParkourFPSCharacter;
+
+// One step of scripted input, held for a number of ticks
+struct FParkourScriptedInput
+{
+	int32 Ticks = 1;
+
+	float Forward = 1.f;
+	float YawRate = 0.f;
+
+	bool MovementKey1 = false;
+	bool MovementKey2 = false;
+	bool MovementKey3 = false;
+	bool CustomJump = false;
+	bool LadderUp = false;
+};
+
+// Looping input sequence used to drive characters without a player, e.g. by the benchmark and soak commandlets.
+// Script files have one step per line: "<Ticks> <Forward> <YawRate> [Key1] [Key2] [Key3] [Jump] [LadderUp]", '#' starts a comment.
+class PARKOURFPS_API FParkourInputScript
+{
+public:
+	// Run, wall run, slide, vertical wall run into a ledge hang and climb, jumps onto ziplines and ladders
+	static FParkourInputScript MakeDefaultCourse();
+
+	bool LoadFromFile(const FString& Filename);
+
+	// Applies the step active at Tick, offset so characters spawned together don't all do the same move at once
+	void Apply(AParkourFPSCharacter* Character, int32 Tick, float DeltaTime) const;
+
+	int32 GetLength() const;
+
+	// Budget slots (ECustomMovementMode, CMOVE_MAX for the walking and falling modes) that the keys held by the script should enter
+	void GetScriptedModes(TArray<uint8>& OutModes) const;
+
+private:
+	const FParkourScriptedInput& GetStep(int32 Tick) const;
+
+	TArray<FParkourScriptedInput> Steps;
+	int32 Length = 0;
+};
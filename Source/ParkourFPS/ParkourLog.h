@@ -0,0 +1,36 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Logging/LogMacros.h"
+
+// Parkour logging is compiled out of Test and Shipping builds entirely
+#define PARKOUR_LOGGING_ENABLED (!NO_LOGGING && !UE_BUILD_SHIPPING && !UE_BUILD_TEST)
+
+DECLARE_LOG_CATEGORY_EXTERN(LogMovementCorrections, Log, All);
+DECLARE_LOG_CATEGORY_EXTERN(LogParkourMovement, Log, All);
+
+// Per feature categories. Messages from the movement tick are logged at Verbose or VeryVerbose,
+// raise a single feature with e.g. "log LogParkourWallRun VeryVerbose" when debugging it.
+DECLARE_LOG_CATEGORY_EXTERN(LogParkourWallRun, Log, All);
+DECLARE_LOG_CATEGORY_EXTERN(LogParkourSlide, Log, All);
+DECLARE_LOG_CATEGORY_EXTERN(LogParkourZipline, Log, All);
+DECLARE_LOG_CATEGORY_EXTERN(LogParkourLadder, Log, All);
+DECLARE_LOG_CATEGORY_EXTERN(LogParkourLedge, Log, All);
+
+#if PARKOUR_LOGGING_ENABLED
+
+// UE_LOG already checks the category verbosity before any of the format arguments are evaluated. The do/while makes the macro
+// a single statement, so it can be used as the body of an unbraced if/else.
+#define PARKOUR_LOG(CategoryName, Verbosity, Format, ...) \
+	do \
+	{ \
+		UE_LOG(CategoryName, Verbosity, Format, ##__VA_ARGS__); \
+	} while (0)
+
+#else
+
+#define PARKOUR_LOG(CategoryName, Verbosity, Format, ...) do {} while (0)
+
+#endif
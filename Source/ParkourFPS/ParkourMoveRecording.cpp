@@ -0,0 +1,131 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ParkourMoveRecording.h"
+#include "HAL/FileManager.h"
+#include "Serialization/Archive.h"
+
+void FParkourRecordedMove::SetControlRotation(const FRotator& Rotation)
+{
+	ControlPitch = FRotator::CompressAxisToShort(Rotation.Pitch);
+	ControlYaw = FRotator::CompressAxisToShort(Rotation.Yaw);
+	ControlRoll = FRotator::CompressAxisToShort(Rotation.Roll);
+}
+
+FRotator FParkourRecordedMove::GetControlRotation() const
+{
+	return FRotator(FRotator::DecompressAxisFromShort(ControlPitch), FRotator::DecompressAxisFromShort(ControlYaw), FRotator::DecompressAxisFromShort(ControlRoll));
+}
+
+void FParkourRecordedMove::SetServerVelocity(const FVector& InVelocity)
+{
+	for (int32 i = 0; i < 3; i++)
+	{
+		ServerVelocity[i] = (int16)FMath::Clamp(FMath::RoundToInt(InVelocity[i]), (int32)MIN_int16, (int32)MAX_int16);
+	}
+}
+
+FVector FParkourRecordedMove::GetServerVelocity() const
+{
+	return FVector(ServerVelocity[0], ServerVelocity[1], ServerVelocity[2]);
+}
+
+FArchive& operator<<(FArchive& Ar, FParkourRecordedMove& Move)
+{
+	Ar << Move.TimeStamp;
+	Ar << Move.DeltaTime;
+	Ar << Move.Acceleration;
+	Ar << Move.CompressedFlags;
+	Ar << Move.ParkourFlags;
+	Ar << Move.ControlPitch;
+	Ar << Move.ControlYaw;
+	Ar << Move.ControlRoll;
+	Ar << Move.ServerLocation;
+	Ar << Move.ServerVelocity[0];
+	Ar << Move.ServerVelocity[1];
+	Ar << Move.ServerVelocity[2];
+	Ar << Move.ServerMovementMode;
+
+	return Ar;
+}
+
+bool FParkourMoveRecording::SaveToFile(const FString& Filename) const
+{
+	TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*Filename));
+
+	if (!Writer)
+	{
+		return false;
+	}
+
+	const_cast<FParkourMoveRecording*>(this)->Serialize(*Writer);
+
+	return Writer->Close();
+}
+
+bool FParkourMoveRecording::LoadFromFile(const FString& Filename)
+{
+	TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*Filename));
+
+	if (!Reader)
+	{
+		return false;
+	}
+
+	Reset();
+	Serialize(*Reader);
+
+	return !Reader->IsError() && Reader->Close();
+}
+
+void FParkourMoveRecording::Reset()
+{
+	MapName.Reset();
+	PlayerName.Reset();
+	StartLocation = FVector::ZeroVector;
+	StartRotation = FRotator::ZeroRotator;
+	StartVelocity = FVector::ZeroVector;
+	StartMovementMode = 0;
+	Moves.Reset();
+}
+
+void FParkourMoveRecording::Serialize(FArchive& Ar)
+{
+	uint32 Magic = FileMagic;
+	uint32 Version = FileVersion;
+
+	Ar << Magic;
+	Ar << Version;
+
+	if (Ar.IsLoading() && (Magic != FileMagic || Version != FileVersion))
+	{
+		Ar.SetError();
+		return;
+	}
+
+	Ar << MapName;
+	Ar << PlayerName;
+	Ar << StartLocation;
+	Ar << StartRotation;
+	Ar << StartVelocity;
+	Ar << StartMovementMode;
+
+	int32 NumMoves = Moves.Num();
+	Ar << NumMoves;
+
+	if (Ar.IsLoading())
+	{
+		if (NumMoves < 0 || Ar.IsError())
+		{
+			Ar.SetError();
+			return;
+		}
+
+		Moves.SetNum(NumMoves);
+	}
+
+	for (FParkourRecordedMove& Move : Moves)
+	{
+		Ar << Move;
+	}
+}
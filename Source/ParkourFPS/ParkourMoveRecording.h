@@ -0,0 +1,70 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// One move of an autonomous proxy as the server ran it, followed by the state the server ended up in.
+// The inputs are stored exactly as they arrived so the move can be re-simulated deterministically.
+struct FParkourRecordedMove
+{
+	float TimeStamp = 0.f;
+	float DeltaTime = 0.f;
+	FVector Acceleration = FVector::ZeroVector;
+
+	// FSavedMove_My::GetCompressedFlags and the EParkourInputFlags::NetworkMoveData intents
+	uint8 CompressedFlags = 0;
+	uint16 ParkourFlags = 0;
+
+	// Control rotation compressed the way ServerMove sends it
+	uint16 ControlPitch = 0;
+	uint16 ControlYaw = 0;
+	uint16 ControlRoll = 0;
+
+	FVector ServerLocation = FVector::ZeroVector;
+
+	// cm/s, only used to resync a replay that diverged
+	int16 ServerVelocity[3] = {};
+
+	// UCharacterMovementComponent::PackNetworkMovementMode
+	uint8 ServerMovementMode = 0;
+
+	void SetControlRotation(const FRotator& Rotation);
+	FRotator GetControlRotation() const;
+
+	void SetServerVelocity(const FVector& InVelocity);
+	FVector GetServerVelocity() const;
+
+	friend FArchive& operator<<(FArchive& Ar, FParkourRecordedMove& Move);
+};
+
+// A character's move stream with the state it started from, recorded on the server with p.Parkour.RecordMoves
+// and re-simulated offline by the ParkourReplay commandlet.
+class PARKOURFPS_API FParkourMoveRecording
+{
+public:
+	static constexpr uint32 FileMagic = 0x524D4B50;
+
+	// Bump whenever the file layout changes
+	static constexpr uint32 FileVersion = 1;
+
+	// Long package name of the map, without a PIE prefix
+	FString MapName;
+	FString PlayerName;
+
+	FVector StartLocation = FVector::ZeroVector;
+	FRotator StartRotation = FRotator::ZeroRotator;
+	FVector StartVelocity = FVector::ZeroVector;
+	uint8 StartMovementMode = 0;
+
+	TArray<FParkourRecordedMove> Moves;
+
+	bool SaveToFile(const FString& Filename) const;
+
+	bool LoadFromFile(const FString& Filename);
+
+	void Reset();
+
+private:
+	void Serialize(FArchive& Ar);
+};
@@ -11,16 +11,90 @@
 #include "DrawDebugHelpers.h"
 #include "Zipline.h"
 #include "Ladder.h"
+#include "ParkourMovementStats.h"
+#include "ParkourTrace.h"
+#include "ParkourCorrectionAnalytics.h"
+#include "ParkourQuantize.h"
+#include "EngineUtils.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/Paths.h"
+#include "GameFramework/GameStateBase.h"
+#include "Engine/NetConnection.h"
+#include "GameFramework/PlayerState.h"
+#include "Misc/PackageName.h"
+#include "Async/Async.h"
 
 DEFINE_LOG_CATEGORY(LogMovementCorrections);
 DEFINE_LOG_CATEGORY(LogParkourMovement);
+DEFINE_LOG_CATEGORY(LogParkourWallRun);
+DEFINE_LOG_CATEGORY(LogParkourSlide);
+DEFINE_LOG_CATEGORY(LogParkourZipline);
+DEFINE_LOG_CATEGORY(LogParkourLadder);
+DEFINE_LOG_CATEGORY(LogParkourLedge);
+
+DEFINE_STAT(STAT_ParkourPhysWallRun);
+DEFINE_STAT(STAT_ParkourPhysVerticalWallRun);
+DEFINE_STAT(STAT_ParkourPhysSlide);
+DEFINE_STAT(STAT_ParkourPhysZipline);
+DEFINE_STAT(STAT_ParkourPhysClimbLadder);
+DEFINE_STAT(STAT_ParkourPhysLedgeHang);
+DEFINE_STAT(STAT_ParkourIsNextToWall);
+DEFINE_STAT(STAT_ParkourCheckWallRunTraces);
+DEFINE_STAT(STAT_ParkourCheckCanHangLedge);
+DEFINE_STAT(STAT_ParkourCheckCanClimb);
+DEFINE_STAT(STAT_ParkourCheckCanQuickClimb);
+DEFINE_STAT(STAT_ParkourCheckCanVault);
+DEFINE_STAT(STAT_ParkourOnActorHit);
+DEFINE_STAT(STAT_ParkourOnMovementUpdated);
+DEFINE_STAT(STAT_ParkourPhysWallRunCalls);
+DEFINE_STAT(STAT_ParkourPhysVerticalWallRunCalls);
+DEFINE_STAT(STAT_ParkourPhysSlideCalls);
+DEFINE_STAT(STAT_ParkourPhysZiplineCalls);
+DEFINE_STAT(STAT_ParkourPhysClimbLadderCalls);
+DEFINE_STAT(STAT_ParkourPhysLedgeHangCalls);
+DEFINE_STAT(STAT_ParkourIsNextToWallCalls);
+DEFINE_STAT(STAT_ParkourCheckWallRunTracesCalls);
+DEFINE_STAT(STAT_ParkourCheckCanHangLedgeCalls);
+DEFINE_STAT(STAT_ParkourCheckCanClimbCalls);
+DEFINE_STAT(STAT_ParkourCheckCanQuickClimbCalls);
+DEFINE_STAT(STAT_ParkourCheckCanVaultCalls);
+DEFINE_STAT(STAT_ParkourWallPlaneCacheHits);
+DEFINE_STAT(STAT_ParkourOnActorHitCalls);
+DEFINE_STAT(STAT_ParkourOnMovementUpdatedCalls);
+DEFINE_STAT(STAT_ParkourOnActorHitCacheHits);
+DEFINE_STAT(STAT_ParkourLineTraces);
+DEFINE_STAT(STAT_ParkourSweeps);
+DEFINE_STAT(STAT_ParkourFloorQueries);
+DEFINE_STAT(STAT_ParkourFloorCacheHits);
+DEFINE_STAT(STAT_ParkourDeferredProbes);
+DEFINE_STAT(STAT_ParkourRpcServerMoveCalls);
+DEFINE_STAT(STAT_ParkourRpcServerMoveBytes);
+DEFINE_STAT(STAT_ParkourSuppressedCorrections);
+DEFINE_STAT(STAT_ParkourSavedMovePoolHits);
+DEFINE_STAT(STAT_ParkourSavedMovePoolMisses);
+DEFINE_STAT(STAT_ParkourSavedMovePoolHighWater);
+
+CSV_DEFINE_CATEGORY_MODULE(PARKOURFPS_API, ParkourMovement, true);
+
+namespace
+{
+	int32 ParkourRecordMoves = 0;
+	FAutoConsoleVariableRef CVarParkourRecordMoves(
+		TEXT("p.Parkour.RecordMoves"),
+		ParkourRecordMoves,
+		TEXT("Server only. Records every autonomous proxy's moves to Saved/ParkourRecordings for the ParkourReplay commandlet."));
+
+	// Ten minutes at 60 moves per second, a full recording is written out and a new one started at the next walking or falling move
+	const int32 MaxRecordedMoves = 36000;
+}
 
 // Things that need to be removed or changed at some point marked with "! DELETE LATER !"
 
 UParkourMovementComponent::UParkourMovementComponent(const FObjectInitializer& ObjectInitializer)
 	:Super(ObjectInitializer)
 {
-
+	SetNetworkMoveDataContainer(ParkourMoveDataContainer);
+	SetMoveResponseDataContainer(ParkourMoveResponseDataContainer);
 }
 
 void UParkourMovementComponent::BeginPlay()
@@ -42,11 +116,25 @@ void UParkourMovementComponent::OnComponentDestroyed(bool bDestroyingHierarchy)
 		GetPawnOwner()->OnActorHit.RemoveDynamic(this, &UParkourMovementComponent::OnActorHit);
 	}
 
+	if (RecordingMoves)
+	{
+		FlushMoveRecording();
+	}
+
 	Super::OnComponentDestroyed(bDestroyingHierarchy);
 }
 
 void UParkourMovementComponent::TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
 {
+	CSV_SCOPED_TIMING_STAT(ParkourMovement, TickComponent);
+
+	const uint32 TickStartCycles = FPlatformTime::Cycles();
+
+	ResetSceneQueryCounters();
+
+	// Movement updates also invalidate the ledge probe, this covers ticks that don't run one
+	LedgeProbe.Valid = false;
+
 	// Only perform checks if the character is controlled from this client
 	if (GetPawnOwner()->IsLocallyControlled())
 	{
@@ -63,6 +151,10 @@ void UParkourMovementComponent::TickComponent(float DeltaTime, enum ELevelTick T
 		WantsToVerticalWallRun = MovementKey3Down;
 	}
 
+	CorrectionRecorder.RecordInputFlags(GetParkourInputFlags());
+
+	RpcAccounting.Tick(DeltaTime);
+
 	if (MovementMode == EMovementMode::MOVE_Flying)
 	{
 		if (ClimbQueued)
@@ -74,6 +166,53 @@ void UParkourMovementComponent::TickComponent(float DeltaTime, enum ELevelTick T
 
 
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	if (CharacterOwner && CharacterOwner->HasAuthority())
+	{
+		GetParkourFPSCharacter()->SetParkourState(BuildReplicatedParkourState());
+	}
+
+	const uint32 TickCycles = FPlatformTime::Cycles() - TickStartCycles;
+
+	AccumulatedTickCycles += TickCycles;
+	AccumulatedTicks++;
+
+	// The report commandlet divides the accumulated stats by CharacterTicks to get per character tick costs
+	CSV_CUSTOM_STAT(ParkourMovement, CharacterTicks, 1, ECsvCustomStatOp::Accumulate);
+	CSV_CUSTOM_STAT(ParkourMovement, MaxCharacterTickMs, (float)FPlatformTime::ToMilliseconds(TickCycles), ECsvCustomStatOp::Max);
+	CSV_CUSTOM_STAT(ParkourMovement, MaxCharacterTickSceneQueries, CurrentTickSceneQueries.GetTotal(), ECsvCustomStatOp::Max);
+
+	if (ModeTickCosts.Num() == 0)
+	{
+		ModeTickCosts.SetNum(CMOVE_MAX + 1);
+	}
+
+	FParkourModeTickCost& ModeTickCost = ModeTickCosts[(MovementMode == MOVE_Custom && CustomMovementMode < CMOVE_MAX) ? CustomMovementMode : CMOVE_MAX];
+	ModeTickCost.Ticks++;
+	ModeTickCost.Cycles += TickCycles;
+	ModeTickCost.MaxSceneQueries = FMath::Max(ModeTickCost.MaxSceneQueries, CurrentTickSceneQueries.GetTotal());
+}
+
+double UParkourMovementComponent::GetAverageTickMs() const
+{
+	if (AccumulatedTicks == 0)
+	{
+		return 0.0;
+	}
+
+	return FPlatformTime::ToMilliseconds64(AccumulatedTickCycles) / AccumulatedTicks;
+}
+
+void UParkourMovementComponent::ResetTickCycles()
+{
+	AccumulatedTickCycles = 0;
+	AccumulatedTicks = 0;
+	ModeTickCosts.Reset();
+}
+
+const TArray<FParkourModeTickCost>& UParkourMovementComponent::GetModeTickCosts() const
+{
+	return ModeTickCosts;
 }
 
 AParkourFPSCharacter* UParkourMovementComponent::GetParkourFPSCharacter()
@@ -81,6 +220,643 @@ AParkourFPSCharacter* UParkourMovementComponent::GetParkourFPSCharacter()
 	return static_cast<AParkourFPSCharacter*>(GetCharacterOwner());
 }
 
+bool UParkourMovementComponent::ParkourLineTrace(FHitResult& OutHit, const FVector& Start, const FVector& End, const FCollisionQueryParams& Params)
+{
+	CurrentTickSceneQueries.LineTraces++;
+	CurrentMoveSceneQueries++;
+	INC_DWORD_STAT(STAT_ParkourLineTraces);
+
+	return GetWorld()->LineTraceSingleByChannel(OutHit, Start, End, ECC_Visibility, Params);
+}
+
+bool UParkourMovementComponent::ParkourSweep(FHitResult& OutHit, const FVector& Start, const FVector& End, const FCollisionShape& Shape, const FCollisionQueryParams& Params)
+{
+	CurrentTickSceneQueries.Sweeps++;
+	CurrentMoveSceneQueries++;
+	INC_DWORD_STAT(STAT_ParkourSweeps);
+
+	return GetWorld()->SweepSingleByChannel(OutHit, Start, End, FQuat::Identity, ECC_Visibility, Shape, Params);
+}
+
+bool UParkourMovementComponent::HasSceneQueryBudget(int32 QueryCost) const
+{
+	if (!EnforceSceneQueryBudget)
+	{
+		return true;
+	}
+
+	return CurrentMoveSceneQueries + QueryCost <= SceneQueryBudgetPerMove;
+}
+
+bool UParkourMovementComponent::MoveUpdatedComponentImpl(const FVector& Delta, const FQuat& NewRotation, bool bSweep, FHitResult* OutHit, ETeleportType Teleport)
+{
+	// MoveComponent doesn't sweep a move that doesn't go anywhere
+	if (bSweep && !Delta.IsNearlyZero())
+	{
+		CurrentTickSceneQueries.Sweeps++;
+		CurrentMoveSceneQueries++;
+		INC_DWORD_STAT(STAT_ParkourSweeps);
+	}
+
+	// The floor sample was taken where the capsule was, a mode that keeps it after moving refreshes it itself
+	if (!Delta.IsNearlyZero())
+	{
+		CustomModeFloorValid = false;
+	}
+
+	return Super::MoveUpdatedComponentImpl(Delta, NewRotation, bSweep, OutHit, Teleport);
+}
+
+void UParkourMovementComponent::ResetSceneQueryCounters()
+{
+	LastTickSceneQueries = CurrentTickSceneQueries;
+
+	CSV_CUSTOM_STAT(ParkourMovement, LineTraces, LastTickSceneQueries.LineTraces, ECsvCustomStatOp::Accumulate);
+	CSV_CUSTOM_STAT(ParkourMovement, Sweeps, LastTickSceneQueries.Sweeps, ECsvCustomStatOp::Accumulate);
+	CSV_CUSTOM_STAT(ParkourMovement, FloorQueries, LastTickSceneQueries.FloorQueries, ECsvCustomStatOp::Accumulate);
+
+	CurrentTickSceneQueries = FParkourSceneQueryCounters();
+}
+
+int64 UParkourMovementComponent::GetPendingSendBits() const
+{
+	const UNetConnection* Connection = CharacterOwner ? CharacterOwner->GetNetConnection() : nullptr;
+
+	return Connection ? Connection->SendBuffer.GetNumBits() : 0;
+}
+
+void UParkourMovementComponent::RecordRpcSent(EParkourRpc::Type Rpc, int64 SendBitsBefore)
+{
+	const int64 SendBitsAfter = GetPendingSendBits();
+
+	// A smaller buffer means it was flushed to make room for the call, so the call is all that's left in it
+	RpcAccounting.RecordCall(Rpc, SendBitsAfter >= SendBitsBefore ? SendBitsAfter - SendBitsBefore : SendBitsAfter);
+}
+
+float UParkourMovementComponent::GetClientNetSendDeltaTime(const APlayerController* PC, const FNetworkPredictionData_Client_Character* ClientData, const FSavedMovePtr& NewMove) const
+{
+	const float NetSendDeltaTime = Super::GetClientNetSendDeltaTime(PC, ClientData, NewMove);
+
+	if (IsInStableParkourMode())
+	{
+		return FMath::Max(NetSendDeltaTime, StableModeNetSendDeltaTime);
+	}
+
+	return NetSendDeltaTime;
+}
+
+bool UParkourMovementComponent::CanDelaySendingMove(const FSavedMovePtr& NewMove)
+{
+	if (!Super::CanDelaySendingMove(NewMove))
+	{
+		return false;
+	}
+
+	const FNetworkPredictionData_Client_Character* ClientData = GetPredictionData_Client_Character();
+	const uint16 NewInputFlags = static_cast<const FSavedMove_My*>(NewMove.Get())->GetParkourInputFlags();
+
+	if (ClientData->PendingMove.IsValid() && static_cast<const FSavedMove_My*>(ClientData->PendingMove.Get())->GetParkourInputFlags() != NewInputFlags)
+	{
+		return false;
+	}
+
+	// NewMove has already been pushed onto SavedMoves, the move before it is the last one that was sent
+	const int32 NumSavedMoves = ClientData->SavedMoves.Num();
+
+	if (NumSavedMoves >= 2 && static_cast<const FSavedMove_My*>(ClientData->SavedMoves[NumSavedMoves - 2].Get())->GetParkourInputFlags() != NewInputFlags)
+	{
+		return false;
+	}
+
+	return true;
+}
+
+bool UParkourMovementComponent::IsInStableParkourMode() const
+{
+	return IsCustomMovementMode(ECustomMovementMode::CMOVE_WallRunning) || IsCustomMovementMode(ECustomMovementMode::CMOVE_Ziplining)
+		|| IsCustomMovementMode(ECustomMovementMode::CMOVE_ClimbLadder);
+}
+
+EParkourNetDynamics UParkourMovementComponent::GetNetDynamics() const
+{
+	if (MovementMode != MOVE_Custom)
+	{
+		return EParkourNetDynamics::Normal;
+	}
+
+	switch (CustomMovementMode)
+	{
+	case ECustomMovementMode::CMOVE_Ziplining:
+	case ECustomMovementMode::CMOVE_ClimbLadder:
+	case ECustomMovementMode::CMOVE_LedgeHang:
+		return EParkourNetDynamics::Predictable;
+	case ECustomMovementMode::CMOVE_WallRunning:
+	case ECustomMovementMode::CMOVE_VerticalWallRunning:
+	case ECustomMovementMode::CMOVE_Sliding:
+	case ECustomMovementMode::CMOVE_ClimbLedge:
+	case ECustomMovementMode::CMOVE_Vaulting:
+		return EParkourNetDynamics::High;
+	default:
+		return EParkourNetDynamics::Normal;
+	}
+}
+
+FParkourReplicatedState UParkourMovementComponent::BuildReplicatedParkourState() const
+{
+	FParkourReplicatedState State;
+
+	if (MovementMode != MOVE_Custom)
+	{
+		return State;
+	}
+
+	State.CustomMode = CustomMovementMode;
+	State.Flags = FParkourReplicatedState::Flag_InCustomMode;
+
+	switch (CustomMovementMode)
+	{
+	case ECustomMovementMode::CMOVE_WallRunning:
+	{
+		State.PackedNormal = ParkourQuantize::PackNormal16(WallRunNormal);
+
+		if (IsWallRunningR)
+		{
+			State.Flags |= FParkourReplicatedState::Flag_WallOnRight;
+		}
+
+		break;
+	}
+	case ECustomMovementMode::CMOVE_VerticalWallRunning:
+	{
+		State.PackedNormal = ParkourQuantize::PackNormal16(VerticalWallRunNormal);
+
+		break;
+	}
+	case ECustomMovementMode::CMOVE_Ziplining:
+	{
+		State.PackedNormal = ParkourQuantize::PackNormal16(ZiplineDirection);
+
+		break;
+	}
+	case ECustomMovementMode::CMOVE_ClimbLadder:
+	{
+		State.PackedNormal = ParkourQuantize::PackNormal16(LadderNormal);
+
+		break;
+	}
+	case ECustomMovementMode::CMOVE_LedgeHang:
+	{
+		State.PackedNormal = ParkourQuantize::PackNormal16(LedgeNormal);
+
+		break;
+	}
+	}
+
+	return State;
+}
+
+void UParkourMovementComponent::ApplyReplicatedParkourState(const FParkourReplicatedState& State)
+{
+	// Zipline and ladder motion is a straight line at a steady speed, so linear smoothing follows it without the lag of exponential smoothing
+	const bool IsOnRail = State.InCustomMode() && (State.CustomMode == ECustomMovementMode::CMOVE_Ziplining || State.CustomMode == ECustomMovementMode::CMOVE_ClimbLadder);
+
+	if (IsOnRail && !RailSmoothingApplied)
+	{
+		SmoothingModeBeforeRail = NetworkSmoothingMode;
+		NetworkSmoothingMode = ENetworkSmoothingMode::Linear;
+		RailSmoothingApplied = true;
+	}
+	else if (!IsOnRail && RailSmoothingApplied)
+	{
+		NetworkSmoothingMode = SmoothingModeBeforeRail;
+		RailSmoothingApplied = false;
+	}
+}
+
+bool UParkourMovementComponent::ServerExceedsAllowablePositionError(float ClientTimeStamp, float DeltaTime, const FVector& Accel, const FVector& ClientWorldLocation,
+	const FVector& RelativeClientLocation, UPrimitiveComponent* ClientMovementBase, FName ClientBaseBoneName, uint8 ClientMovementMode)
+{
+	if (!Super::ServerExceedsAllowablePositionError(ClientTimeStamp, DeltaTime, Accel, ClientWorldLocation, RelativeClientLocation, ClientMovementBase, ClientBaseBoneName, ClientMovementMode))
+	{
+		return false;
+	}
+
+	const FNetworkPredictionData_Server_Character* ServerData = GetPredictionData_Server_Character();
+
+	if (ServerData && ServerData->bForceClientUpdate)
+	{
+		return true;
+	}
+
+	// Tolerances only apply while client and server agree on the mode
+	TEnumAsByte<EMovementMode> ClientNetMode;
+	uint8 ClientNetCustomMode;
+	TEnumAsByte<EMovementMode> ClientNetGroundMode;
+	UnpackNetworkMovementMode(ClientMovementMode, ClientNetMode, ClientNetCustomMode, ClientNetGroundMode);
+
+	if (MovementMode != MOVE_Custom || ClientNetMode != MOVE_Custom || ClientNetCustomMode != CustomMovementMode)
+	{
+		return true;
+	}
+
+	const FParkourErrorTolerance* Tolerance = GetErrorTolerance(CustomMovementMode);
+
+	if (Tolerance == nullptr)
+	{
+		return true;
+	}
+
+	const float PositionError = FVector::Dist(UpdatedComponent->GetComponentLocation(), ClientWorldLocation);
+
+	if (PositionError > Tolerance->PositionTolerance + Tolerance->DriftTolerance * DeltaTime)
+	{
+		return true;
+	}
+
+	if (SuppressedCorrections.Num() == 0)
+	{
+		SuppressedCorrections.SetNumZeroed(CMOVE_MAX);
+	}
+
+	SuppressedCorrections[CustomMovementMode]++;
+
+	INC_DWORD_STAT(STAT_ParkourSuppressedCorrections);
+	CSV_CUSTOM_STAT(ParkourMovement, SuppressedCorrections, 1, ECsvCustomStatOp::Accumulate);
+
+	PARKOUR_LOG(LogMovementCorrections, Verbose, TEXT("Suppressed correction in mode %i, position error %f"), CustomMovementMode, PositionError);
+
+	return false;
+}
+
+const FParkourErrorTolerance* UParkourMovementComponent::GetErrorTolerance(uint8 InCustomMovementMode) const
+{
+	switch (InCustomMovementMode)
+	{
+	case ECustomMovementMode::CMOVE_WallRunning:			return &WallRunErrorTolerance;
+	case ECustomMovementMode::CMOVE_VerticalWallRunning:	return &VerticalWallRunErrorTolerance;
+	case ECustomMovementMode::CMOVE_Sliding:				return &SlideErrorTolerance;
+	case ECustomMovementMode::CMOVE_Ziplining:				return &ZiplineErrorTolerance;
+	case ECustomMovementMode::CMOVE_ClimbLadder:			return &LadderErrorTolerance;
+	case ECustomMovementMode::CMOVE_LedgeHang:				return &LedgeHangErrorTolerance;
+	default:												return nullptr;
+	}
+}
+
+const TArray<int32>& UParkourMovementComponent::GetSuppressedCorrections() const
+{
+	return SuppressedCorrections;
+}
+
+void UParkourMovementComponent::SimulateMovement(float DeltaTime)
+{
+	if (CharacterOwner && CharacterOwner->GetLocalRole() == ROLE_SimulatedProxy && SimulateRailMovement(DeltaTime))
+	{
+		return;
+	}
+
+	Super::SimulateMovement(DeltaTime);
+}
+
+bool UParkourMovementComponent::SimulateRailMovement(float DeltaTime)
+{
+	const FParkourRailState& RailState = GetParkourFPSCharacter()->GetRailState();
+	const AGameStateBase* GameState = GetWorld()->GetGameState();
+
+	if (RailState.Rail == nullptr || GameState == nullptr || !UpdatedComponent)
+	{
+		return false;
+	}
+
+	FVector RailDirection;
+	float MinDistance;
+	float MaxDistance;
+
+	if (AZipline* Zipline = Cast<AZipline>(RailState.Rail))
+	{
+		RailDirection = Zipline->GetZiplineDirection();
+		MinDistance = 0.f;
+		MaxDistance = FMath::Max(FVector::DotProduct(Zipline->EndPoint - RailState.AnchorLocation, RailDirection), 0.f);
+	}
+	else if (ALadder* Ladder = Cast<ALadder>(RailState.Rail))
+	{
+		RailDirection = FVector::UpVector;
+		MinDistance = FMath::Min(Ladder->BottomPoint.Z - RailState.AnchorLocation.Z, 0.f);
+		MaxDistance = FMath::Max(Ladder->TopPoint.Z - RailState.AnchorLocation.Z, 0.f);
+	}
+	else
+	{
+		return false;
+	}
+
+	const float Elapsed = FMath::Max(GameState->GetServerWorldTimeSeconds() - RailState.AnchorServerTime, 0.f);
+
+	// Constant acceleration along the rail until MaxSpeed is reached, constant speed after that
+	float AccelerationTime = Elapsed;
+
+	if (RailState.MaxSpeed > 0.f && RailState.Acceleration > 0.f)
+	{
+		AccelerationTime = FMath::Clamp((RailState.MaxSpeed - RailState.AnchorSpeed) / RailState.Acceleration, 0.f, Elapsed);
+	}
+
+	const float SpeedAfterAcceleration = RailState.AnchorSpeed + RailState.Acceleration * AccelerationTime;
+	float Distance = RailState.AnchorSpeed * AccelerationTime + 0.5f * RailState.Acceleration * FMath::Square(AccelerationTime)
+		+ SpeedAfterAcceleration * (Elapsed - AccelerationTime);
+
+	// Past an end of the rail the proxy waits there for the server to clear the anchor, it shouldn't look like it's still moving
+	if (Distance < MinDistance || Distance > MaxDistance)
+	{
+		Distance = FMath::Clamp(Distance, MinDistance, MaxDistance);
+		Velocity = FVector::ZeroVector;
+	}
+	else
+	{
+		Velocity = RailDirection * SpeedAfterAcceleration;
+	}
+
+	UpdatedComponent->SetWorldLocation(RailState.AnchorLocation + RailDirection * Distance, false);
+
+	return true;
+}
+
+void UParkourMovementComponent::UpdateRailAnchor(AActor* Rail, float AlongRailSpeed, float AlongRailAcceleration, float MaxSpeed)
+{
+	const AGameStateBase* GameState = GetWorld()->GetGameState();
+	AParkourFPSCharacter* ParkourCharacter = GetParkourFPSCharacter();
+
+	FParkourRailState RailState;
+	RailState.Rail = Rail;
+	RailState.AnchorLocation = UpdatedComponent->GetComponentLocation();
+	RailState.AnchorServerTime = GameState ? GameState->GetServerWorldTimeSeconds() : GetWorld()->GetTimeSeconds();
+	RailState.AnchorSpeed = AlongRailSpeed;
+	RailState.Acceleration = AlongRailAcceleration;
+	RailState.MaxSpeed = MaxSpeed;
+
+	ParkourCharacter->SetRailState(RailState);
+}
+
+void UParkourMovementComponent::ClearRailAnchor()
+{
+	AParkourFPSCharacter* ParkourCharacter = GetParkourFPSCharacter();
+
+	if (!CharacterOwner->HasAuthority() || ParkourCharacter->GetRailState().Rail == nullptr)
+	{
+		return;
+	}
+
+	ParkourCharacter->SetRailState(FParkourRailState());
+
+	// Push the final position out right away instead of waiting for the next low frequency update
+	ParkourCharacter->ForceNetUpdate();
+}
+
+bool UParkourMovementComponent::IsRailAnchorStale(const AActor* Rail) const
+{
+	const FParkourRailState& RailState = static_cast<AParkourFPSCharacter*>(CharacterOwner)->GetRailState();
+	const AGameStateBase* GameState = GetWorld()->GetGameState();
+	const float Now = GameState ? GameState->GetServerWorldTimeSeconds() : GetWorld()->GetTimeSeconds();
+
+	return RailState.Rail != Rail || Now - RailState.AnchorServerTime >= RailReanchorInterval;
+}
+
+void UParkourMovementComponent::ClientHandleMoveResponse(const FCharacterMoveResponseDataContainer& MoveResponse)
+{
+	// Restore before the correction is applied, so OnMovementModeChanged already sees the server's mode state
+	const FParkourMoveResponseDataContainer& ParkourMoveResponse = static_cast<const FParkourMoveResponseDataContainer&>(MoveResponse);
+
+	if (ParkourMoveResponse.bHasParkourState)
+	{
+		RestoreParkourState(ParkourMoveResponse);
+	}
+
+	Super::ClientHandleMoveResponse(MoveResponse);
+}
+
+void UParkourMovementComponent::RestoreParkourState(const FParkourMoveResponseDataContainer& MoveResponse)
+{
+	const FVector Normal = ParkourQuantize::UnpackNormal16(MoveResponse.PackedNormal);
+
+	IsWallRunning = MoveResponse.ParkourMode == ECustomMovementMode::CMOVE_WallRunning;
+	IsVerticalWallRunning = MoveResponse.ParkourMode == ECustomMovementMode::CMOVE_VerticalWallRunning;
+	IsZiplining = MoveResponse.ParkourMode == ECustomMovementMode::CMOVE_Ziplining;
+	IsClimbingLadder = MoveResponse.ParkourMode == ECustomMovementMode::CMOVE_ClimbLadder;
+	IsLedgeHanging = MoveResponse.ParkourMode == ECustomMovementMode::CMOVE_LedgeHang;
+
+	switch (MoveResponse.ParkourMode)
+	{
+	case ECustomMovementMode::CMOVE_WallRunning:
+	{
+		WallRunNormal = Normal;
+		IsWallRunningR = MoveResponse.bWallOnRight;
+		IsWallRunningL = !MoveResponse.bWallOnRight;
+
+		break;
+	}
+	case ECustomMovementMode::CMOVE_VerticalWallRunning:
+	{
+		VerticalWallRunNormal = Normal;
+
+		break;
+	}
+	case ECustomMovementMode::CMOVE_Ziplining:
+	{
+		if (AZipline* Zipline = Cast<AZipline>(MoveResponse.RailActor))
+		{
+			CurrentZipline = Zipline;
+			ZiplineStart = Zipline->StartPoint;
+			ZiplineEnd = Zipline->EndPoint;
+			ZiplineDirection = Zipline->GetZiplineDirection();
+		}
+
+		break;
+	}
+	case ECustomMovementMode::CMOVE_ClimbLadder:
+	{
+		if (ALadder* Ladder = Cast<ALadder>(MoveResponse.RailActor))
+		{
+			CurrentLadder = Ladder;
+			LadderTop = Ladder->TopPoint;
+			LadderBottom = Ladder->BottomPoint;
+		}
+
+		LadderNormal = Normal;
+
+		break;
+	}
+	case ECustomMovementMode::CMOVE_LedgeHang:
+	{
+		LedgeNormal = Normal;
+		LedgeHeight = MoveResponse.LedgeHeight;
+
+		break;
+	}
+	}
+
+	PARKOUR_LOG(LogMovementCorrections, Verbose, TEXT("Restored parkour state for mode %i from correction"), MoveResponse.ParkourMode);
+}
+
+void UParkourMovementComponent::MoveAutonomous(float ClientTimeStamp, float DeltaTime, uint8 CompressedFlags, const FVector& NewAccel)
+{
+	// The intents that don't fit in the compressed flags arrive with the move itself
+	const FParkourNetworkMoveData* MoveData = static_cast<const FParkourNetworkMoveData*>(GetCurrentNetworkMoveData());
+
+	if (MoveData)
+	{
+		ApplyNetworkMoveDataFlags(MoveData->ParkourFlags);
+	}
+
+	const bool RecordMove = ParkourRecordMoves != 0 && CharacterOwner->GetRemoteRole() == ROLE_AutonomousProxy;
+
+	if (RecordMove && !RecordingMoves && CanStartMoveRecording())
+	{
+		StartMoveRecording();
+	}
+	else if (!RecordMove && RecordingMoves)
+	{
+		FlushMoveRecording();
+		RecordingMoves = false;
+	}
+
+	Super::MoveAutonomous(ClientTimeStamp, DeltaTime, CompressedFlags, NewAccel);
+
+	if (RecordingMoves)
+	{
+		RecordAutonomousMove(ClientTimeStamp, DeltaTime, CompressedFlags, NewAccel, MoveData ? MoveData->ParkourFlags : 0);
+	}
+}
+
+bool UParkourMovementComponent::CanStartMoveRecording() const
+{
+	if (MovementMode != MOVE_Walking && MovementMode != MOVE_Falling)
+	{
+		return false;
+	}
+
+	return !IsWallRunning && !IsVerticalWallRunning && !IsSliding && !IsCrouched && !IsZiplining && !IsClimbingLadder && !IsLedgeHanging && !IsClimbingLedge &&
+		!EndClimbQueued;
+}
+
+void UParkourMovementComponent::StartMoveRecording()
+{
+	MoveRecording.Reset();
+
+	// The replay starts with an empty hit cache, so the recorded moves have to as well or they would skip different hit classifications
+	for (FParkourHitCacheEntry& Entry : HitCache)
+	{
+		Entry = FParkourHitCacheEntry();
+	}
+
+	NextHitCacheEntry = 0;
+	MoveRecording.MapName = UWorld::RemovePIEPrefix(GetWorld()->GetOutermost()->GetName());
+	MoveRecording.PlayerName = CharacterOwner->GetPlayerState() ? CharacterOwner->GetPlayerState()->GetPlayerName() : CharacterOwner->GetName();
+	MoveRecording.StartLocation = UpdatedComponent->GetComponentLocation();
+	MoveRecording.StartRotation = UpdatedComponent->GetComponentRotation();
+	MoveRecording.StartVelocity = Velocity;
+	MoveRecording.StartMovementMode = PackNetworkMovementMode();
+
+	RecordingMoves = true;
+}
+
+void UParkourMovementComponent::RecordAutonomousMove(float ClientTimeStamp, float DeltaTime, uint8 CompressedFlags, const FVector& NewAccel, uint16 ParkourFlags)
+{
+	FParkourRecordedMove& Move = MoveRecording.Moves.AddDefaulted_GetRef();
+
+	Move.TimeStamp = ClientTimeStamp;
+	Move.DeltaTime = DeltaTime;
+	Move.Acceleration = NewAccel;
+	Move.CompressedFlags = CompressedFlags;
+	Move.ParkourFlags = ParkourFlags;
+	Move.SetControlRotation(CharacterOwner->GetControlRotation());
+	Move.ServerLocation = UpdatedComponent->GetComponentLocation();
+	Move.SetServerVelocity(Velocity);
+	Move.ServerMovementMode = PackNetworkMovementMode();
+
+	// Start the next file from the state after the last move of this one, waiting for a move the start state fully describes
+	if (MoveRecording.Moves.Num() >= MaxRecordedMoves && CanStartMoveRecording())
+	{
+		FlushMoveRecording();
+		StartMoveRecording();
+	}
+}
+
+void UParkourMovementComponent::FlushMoveRecording()
+{
+	if (MoveRecording.Moves.Num() == 0)
+	{
+		return;
+	}
+
+	const FString Filename = FPaths::ProjectSavedDir() / TEXT("ParkourRecordings") / FString::Printf(TEXT("%s_%s_%u_%s.pkmv"),
+		*FPackageName::GetShortName(MoveRecording.MapName), *FPaths::MakeValidFileName(MoveRecording.PlayerName), GetUniqueID(), *FDateTime::Now().ToString());
+
+	// A full recording is several megabytes, writing it on the game thread would hitch the server
+	Async(EAsyncExecution::ThreadPool, [Recording = MoveTemp(MoveRecording), Filename]()
+	{
+		if (Recording.SaveToFile(Filename))
+		{
+			UE_LOG(LogMovementCorrections, Display, TEXT("Wrote %d recorded moves to %s"), Recording.Moves.Num(), *Filename);
+		}
+		else
+		{
+			UE_LOG(LogMovementCorrections, Warning, TEXT("Failed to write recorded moves to %s"), *Filename);
+		}
+	});
+
+	MoveRecording.Reset();
+}
+
+int32 UParkourMovementComponent::ReplayRecordedMove(const FParkourRecordedMove& Move)
+{
+	const FRotator ControlRotation = Move.GetControlRotation();
+
+	// ServerMove sets the control rotation and turns the pawn before it runs the move
+	if (AController* Controller = CharacterOwner->GetController())
+	{
+		Controller->SetControlRotation(ControlRotation);
+	}
+
+	CharacterOwner->FaceRotation(ControlRotation, Move.DeltaTime);
+
+	ResetSceneQueryCounters();
+	ApplyNetworkMoveDataFlags(Move.ParkourFlags);
+
+	Super::MoveAutonomous(Move.TimeStamp, Move.DeltaTime, Move.CompressedFlags, Move.Acceleration);
+
+	return CurrentTickSceneQueries.GetTotal();
+}
+
+void UParkourMovementComponent::CallServerMove(const FSavedMove_Character* NewMove, const FSavedMove_Character* OldMove)
+{
+	const int64 SendBits = GetPendingSendBits();
+	Super::CallServerMove(NewMove, OldMove);
+	RecordRpcSent(EParkourRpc::ServerMove, SendBits);
+}
+
+void UParkourMovementComponent::CallServerMovePacked(const FSavedMove_Character* NewMove, const FSavedMove_Character* PendingMove, const FSavedMove_Character* OldMove)
+{
+	const int64 SendBits = GetPendingSendBits();
+	Super::CallServerMovePacked(NewMove, PendingMove, OldMove);
+	RecordRpcSent(EParkourRpc::ServerMove, SendBits);
+}
+
+const FParkourRpcAccounting& UParkourMovementComponent::GetRpcAccounting() const
+{
+	return RpcAccounting;
+}
+
+FParkourSceneQueryCounters UParkourMovementComponent::GetLastTickSceneQueries() const
+{
+	return LastTickSceneQueries;
+}
+
+void UParkourMovementComponent::FindFloor(const FVector& CapsuleLocation, FFindFloorResult& OutFloorResult, bool bCanUseCachedLocation, const FHitResult* DownwardSweepResult) const
+{
+	CurrentTickSceneQueries.FloorQueries++;
+	CurrentMoveSceneQueries++;
+	INC_DWORD_STAT(STAT_ParkourFloorQueries);
+
+	Super::FindFloor(CapsuleLocation, OutFloorResult, bCanUseCachedLocation, DownwardSweepResult);
+}
+
 void UParkourMovementComponent::SetCameraRotationLimit(float MinPitch, float MaxPitch, float MinRoll, float MaxRoll, float MinYaw, float MaxYaw)
 {
 	if (GetPawnOwner()->IsLocallyControlled() == false)
@@ -126,6 +902,19 @@ void UParkourMovementComponent::UpdateFromCompressedFlags(uint8 Flags)
 
 void UParkourMovementComponent::UpdateCharacterStateBeforeMovement(float DeltaSeconds)
 {
+	CurrentMoveSceneQueries = 0;
+	MoveTimeSeconds += DeltaSeconds;
+
+	LedgeProbe.Valid = false;
+
+	// Ledge probes deferred by the last move because it had used up its scene query budget. They run as part of this move so the
+	// server runs them in the same ServerMove the client ran them in.
+	if (LedgeProbesDeferred)
+	{
+		LedgeProbesDeferred = false;
+		RunLedgeProbes();
+	}
+
 	if (WantsToWallRun && IsWallRunning && !IsCustomMovementMode(ECustomMovementMode::CMOVE_WallRunning))
 	{
 		SetMovementMode(EMovementMode::MOVE_Custom, ECustomMovementMode::CMOVE_WallRunning);
@@ -158,13 +947,28 @@ void UParkourMovementComponent::OnMovementModeChanged(EMovementMode PreviousMove
 {
 	if (PreviousMovementMode != MovementMode || PreviousCustomMode != CustomMovementMode)
 	{
-		const FString MovementModeString = StaticEnum<EMovementMode>()->GetValueAsString(MovementMode);
-		UE_LOG(LogParkourMovement, Log, TEXT("Current Movement Mode: %s %s"), *MovementModeString, *CharacterOwner->GetName());
+		PARKOUR_TRACE_MODE_CHANGE(CharacterOwner, PreviousMovementMode, PreviousCustomMode, MovementMode, CustomMovementMode);
+
+		PARKOUR_LOG(LogParkourMovement, Log, TEXT("Current Movement Mode: %s %s"), *StaticEnum<EMovementMode>()->GetValueAsString(MovementMode), *CharacterOwner->GetName());
 
 		//UE_LOG(LogParkourMovement, Warning, TEXT("Movement Mode Changed To:  %i %s"), MovementMode, *CharacterOwner->GetName());
 
 		if (MovementMode == EMovementMode::MOVE_Custom)
-			UE_LOG(LogParkourMovement, Warning, TEXT("Custom Movement Mode Changed To: %i %s"), CustomMovementMode, *CharacterOwner->GetName());
+			PARKOUR_LOG(LogParkourMovement, Log, TEXT("Custom Movement Mode Changed To: %i %s"), CustomMovementMode, *CharacterOwner->GetName());
+
+		if (CharacterOwner->HasAuthority())
+		{
+			GetParkourFPSCharacter()->UpdateAdaptiveNetUpdateFrequency();
+		}
+
+		// The base class clears or recomputes CurrentFloor on a mode change
+		CustomModeFloorValid = false;
+
+		// Leaving the slide for any other mode, e.g. jumping or sliding off a ledge, ends it
+		if (PreviousMovementMode == EMovementMode::MOVE_Custom && PreviousCustomMode == ECustomMovementMode::CMOVE_Sliding && IsSliding)
+		{
+			EndSlide();
+		}
 	}
 
 	if (MovementMode == MOVE_Custom)
@@ -200,36 +1004,20 @@ void UParkourMovementComponent::OnMovementModeChanged(EMovementMode PreviousMove
 	}
 
 	Super::OnMovementModeChanged(PreviousMovementMode, PreviousCustomMode);
+
+	// The base class only keeps the base location for crouching in the walking modes, the slide crouches as it starts
+	if (IsCustomMovementMode(ECustomMovementMode::CMOVE_Sliding))
+	{
+		bCrouchMaintainsBaseLocation = true;
+	}
 }
 
 void UParkourMovementComponent::OnMovementUpdated(float DeltaSeconds, const FVector& OldLocation, const FVector& OldVelocity)
 {
-	Super::OnMovementUpdated(DeltaSeconds, OldLocation, OldVelocity);
-
-	if (PawnOwner->GetLocalRole() == ROLE_AutonomousProxy)
-	{
-		if (MovementMode == EMovementMode::MOVE_Custom)
-		{
-			ServerSetWantsToCustomJump(WantsToCustomJump);
-		}
+	PARKOUR_SCOPE_CYCLE_COUNTER(STAT_ParkourOnMovementUpdated);
+	CSV_SCOPED_TIMING_STAT(ParkourMovement, OnMovementUpdated);
 
-		if (IsVerticalWallRunning)
-		{
-			ServerSetWantsToVerticalWallRunRotate(WantsToVerticalWallRunRotate);
-		}
-		
-		if (IsClimbingLadder)
-		{
-			ServerSetWantsToGoUpLadder(WantsToClimbLadderUp);
-			ServerSetWantsToGoDownLadder(WantsToClimbLadderDown);
-		}
-		if (IsLedgeHanging)
-		{
-			ServerSetWantsToStopLedgeHang(WantsToStopLedgeHang);
-		}
-
-		ServerSetWantsToClimbLedge(WantsToClimbLedge);
-	}
+	Super::OnMovementUpdated(DeltaSeconds, OldLocation, OldVelocity);
 
 	DoCustomJump();
 
@@ -256,53 +1044,80 @@ void UParkourMovementComponent::OnMovementUpdated(float DeltaSeconds, const FVec
 
 void UParkourMovementComponent::OnActorHit(AActor* SelfActor, AActor* OtherActor, FVector NormalImpulse, const FHitResult& Hit)
 {
+	PARKOUR_SCOPE_CYCLE_COUNTER(STAT_ParkourOnActorHit);
+	CSV_SCOPED_TIMING_STAT(ParkourMovement, OnActorHit);
+
 	if (GetPawnOwner()->GetLocalRole() <= ROLE_SimulatedProxy)
 	{
 		return;
 	}
 
-	bool LedgeHang = CheckCanHangLedge();
+	// Pressing against geometry fires a hit every move, only classify again once something that matters has changed
+	const bool UseHitCache = OnActorHitCacheLifetime > 0.f && Hit.Component.IsValid();
+	FParkourHitCacheEntry HitKey;
 
-	if (LedgeHang)
-	{
-		UE_LOG(LogParkourMovement, Warning, TEXT("Actor Hit Ledge Grab TRUE"));
-	}
-	else
+	if (UseHitCache)
 	{
-		UE_LOG(LogParkourMovement, Warning, TEXT("Actor Hit Ledge Grab FALSE"));
+		HitKey = MakeHitCacheEntry(Hit);
+
+		for (const FParkourHitCacheEntry& Entry : HitCache)
+		{
+			if (HitKey.Time - Entry.Time <= OnActorHitCacheLifetime && Entry.Matches(HitKey))
+			{
+				INC_DWORD_STAT(STAT_ParkourOnActorHitCacheHits);
+				return;
+			}
+		}
 	}
 
-	bool LedgeClimb = CheckCanClimb();
+	const uint8 PreviousMovementMode = MovementMode;
+	const uint8 PreviousCustomMode = CustomMovementMode;
 
-	if (LedgeClimb)
-	{
-		UE_LOG(LogParkourMovement, Warning, TEXT("Actor Hit Ledge Climb TRUE"));
-	}
-	else
+	ClassifyActorHit(OtherActor, Hit);
+
+	const bool StartedMove = MovementMode != PreviousMovementMode || CustomMovementMode != PreviousCustomMode || IsWallRunning || IsVerticalWallRunning ||
+		IsZiplining || IsClimbingLadder;
+
+	if (UseHitCache && !StartedMove)
 	{
-		UE_LOG(LogParkourMovement, Warning, TEXT("Actor Hit Ledge Climb FALSE"));
+		HitCache[NextHitCacheEntry] = HitKey;
+		NextHitCacheEntry = (NextHitCacheEntry + 1) % NumHitCacheEntries;
 	}
+}
 
-	bool LedgeQuickClimb = CheckCanQuickClimb();
+FParkourHitCacheEntry UParkourMovementComponent::MakeHitCacheEntry(const FHitResult& Hit) const
+{
+	FParkourHitCacheEntry Entry;
 
-	if (LedgeQuickClimb)
-	{
-		UE_LOG(LogParkourMovement, Warning, TEXT("Actor Hit Ledge Quick Climb TRUE"));
+	const FVector RelativeLocation = CharacterOwner->GetActorLocation() - Hit.Component->GetComponentLocation();
 
-		bool LedgeVault = CheckCanVault();
+	Entry.Component = Hit.Component.Get();
+	Entry.NormalBucket = FIntVector(FMath::RoundToInt(Hit.ImpactNormal.X * 8.f), FMath::RoundToInt(Hit.ImpactNormal.Y * 8.f), FMath::RoundToInt(Hit.ImpactNormal.Z * 8.f));
+	Entry.PositionBucket = FIntVector(FMath::FloorToInt(RelativeLocation.X / OnActorHitCachePositionBucket), FMath::FloorToInt(RelativeLocation.Y / OnActorHitCachePositionBucket),
+		FMath::FloorToInt(RelativeLocation.Z / OnActorHitCachePositionBucket));
+	Entry.YawBucket = FMath::FloorToInt(FRotator::ClampAxis(UpdatedComponent->GetComponentRotation().Yaw) / OnActorHitCacheYawBucket);
+	Entry.InputFlags = GetParkourInputFlags();
+	Entry.MovementMode = MovementMode;
+	Entry.CustomMovementMode = CustomMovementMode;
+	Entry.Time = MoveTimeSeconds;
 
-		if (LedgeVault)
-		{
-			UE_LOG(LogParkourMovement, Warning, TEXT("Actor Hit Ledge Vault TRUE"));
-		}
-		else
-		{
-			UE_LOG(LogParkourMovement, Warning, TEXT("Actor Hit Ledge Vault FALSE"));
-		}
+	return Entry;
+}
+
+void UParkourMovementComponent::ClassifyActorHit(AActor* OtherActor, const FHitResult& Hit)
+{
+	// The ledge probes are the lowest priority queries, push them to the next move if this move is already over budget.
+	// The shared ledge probe and vault cost up to 3 line traces and a sweep between them.
+	if (HasSceneQueryBudget(4))
+	{
+		RunLedgeProbes();
 	}
-	else
+	else if (!LedgeProbesDeferred)
 	{
-		UE_LOG(LogParkourMovement, Warning, TEXT("Actor Hit Ledge Quick Climb FALSE"));
+		LedgeProbesDeferred = true;
+
+		CurrentTickSceneQueries.DeferredProbes++;
+		INC_DWORD_STAT(STAT_ParkourDeferredProbes);
 	}
 
 	// return if a custom move is already being performed
@@ -331,6 +1146,7 @@ void UParkourMovementComponent::OnActorHit(AActor* SelfActor, AActor* OtherActor
 
 			if (CanClimbLadder)
 			{
+				CurrentLadder = static_cast<ALadder*>(OtherActor);
 				LadderTop = static_cast<ALadder*>(OtherActor)->TopPoint;
 				LadderBottom = static_cast<ALadder*>(OtherActor)->BottomPoint;
 			}
@@ -390,6 +1206,8 @@ FVector UParkourMovementComponent::GetDirectionOfSurface(FVector ImpactNormal)
 
 bool UParkourMovementComponent::CheckCanWallRun(const FHitResult Hit)
 {
+	PARKOUR_TRACE_PROBE_SCOPE(CharacterOwner, EParkourProbe::CheckCanWallRun);
+
 	if (WantsToWallRun == false)
 	{
 		return false;
@@ -424,6 +1242,7 @@ bool UParkourMovementComponent::CheckCanWallRun(const FHitResult Hit)
 
 	BeginWallRun();
 
+	PARKOUR_TRACE_PROBE_HIT();
 	return true;
 }
 
@@ -432,24 +1251,21 @@ bool UParkourMovementComponent::CheckWallRunFloor(float Distance)
 	//looks to see if the player is on the floor while wall running and returns false if the player is currently standing on a floor,
 	//as the wall run should end when the player hits the floor
 
-	FFindFloorResult FloorResult;
-	FHitResult* HitResult = NULL;
+	const FFindFloorResult& FloorResult = GetCustomModeFloor();
 
-	FindFloor(CharacterOwner->GetActorLocation(), FloorResult, false, HitResult);
-
-	if (HitResult != NULL)
+	if (FloorResult.bBlockingHit)
 	{
-		UE_LOG(LogParkourMovement, Warning, TEXT("Floor Name: %s"), *HitResult->GetActor()->GetName());
+		PARKOUR_LOG(LogParkourWallRun, VeryVerbose, TEXT("Floor Name: %s"), *GetNameSafe(FloorResult.HitResult.GetActor()));
 	}
 	
 	if (FloorResult.bWalkableFloor == false)
 	{
-		UE_LOG(LogParkourMovement, Warning, TEXT("Floor Not Found"));
+		PARKOUR_LOG(LogParkourWallRun, VeryVerbose, TEXT("Floor Not Found"));
 
 		return true;
 	}
 
-	UE_LOG(LogParkourMovement, Warning, TEXT("Floor Distance: %f"), FloorResult.FloorDist);
+	PARKOUR_LOG(LogParkourWallRun, VeryVerbose, TEXT("Floor Distance: %f"), FloorResult.FloorDist);
 
 	if (FloorResult.FloorDist < Distance)
 	{
@@ -459,8 +1275,31 @@ bool UParkourMovementComponent::CheckWallRunFloor(float Distance)
 	return true;
 }
 
+const FFindFloorResult& UParkourMovementComponent::GetCustomModeFloor()
+{
+	if (CustomModeFloorValid && !bJustTeleported)
+	{
+		INC_DWORD_STAT(STAT_ParkourFloorCacheHits);
+		return CurrentFloor;
+	}
+
+	// The custom modes only need to know whether a floor is right under the capsule, so skip FindFloor's full height search and perch checks
+	CurrentTickSceneQueries.FloorQueries++;
+	CurrentMoveSceneQueries++;
+	INC_DWORD_STAT(STAT_ParkourFloorQueries);
+
+	ComputeFloorDist(UpdatedComponent->GetComponentLocation(), FloorCacheSweepDistance, FloorCacheSweepDistance, CurrentFloor, CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleRadius());
+
+	CustomModeFloorValid = true;
+
+	return CurrentFloor;
+}
+
 bool UParkourMovementComponent::CheckWallRunTraces()
 {
+	PARKOUR_SCOPE_CYCLE_COUNTER(STAT_ParkourCheckWallRunTraces);
+	PARKOUR_TRACE_PROBE_SCOPE(CharacterOwner, EParkourProbe::CheckWallRunTraces);
+
 	FVector TraceStart = CharacterOwner->GetActorLocation();
 	FCollisionQueryParams TraceParams;
 	TraceParams.AddIgnoredActor(CharacterOwner);
@@ -468,7 +1307,7 @@ bool UParkourMovementComponent::CheckWallRunTraces()
 	// Line trace to the left of the character
 	FHitResult HitL;
 	FVector TraceEnd = GetWallRunEndVectorL();
-	GetWorld()->LineTraceSingleByChannel(HitL, TraceStart, TraceEnd, ECC_Visibility, TraceParams);
+	ParkourLineTrace(HitL, TraceStart, TraceEnd, TraceParams);
 
 	// If the trace hits another actor check if it is valid
 	if (HitL.bBlockingHit)
@@ -479,18 +1318,19 @@ bool UParkourMovementComponent::CheckWallRunTraces()
 
 			WallRunImpactNormal = HitL.ImpactNormal;
 
-			UE_LOG(LogParkourMovement, Warning, TEXT("CHECK PASSED L"));
+			PARKOUR_LOG(LogParkourWallRun, Verbose, TEXT("CHECK PASSED L"));
 
+			PARKOUR_TRACE_PROBE_HIT();
 			return true;
 		}
 	}
 
-	UE_LOG(LogParkourMovement, Warning, TEXT("HIT L FAILED"));
+	PARKOUR_LOG(LogParkourWallRun, Verbose, TEXT("HIT L FAILED"));
 
 	// Line trace to the right of the character
 	FHitResult HitR;
 	TraceEnd = GetWallRunEndVectorR();
-	GetWorld()->LineTraceSingleByChannel(HitL, TraceStart, TraceEnd, ECC_Visibility, TraceParams);
+	ParkourLineTrace(HitL, TraceStart, TraceEnd, TraceParams);
 
 	// If the trace hits another actor check if it is valid
 	if (HitL.bBlockingHit)
@@ -501,14 +1341,15 @@ bool UParkourMovementComponent::CheckWallRunTraces()
 
 			WallRunImpactNormal = HitL.ImpactNormal;
 
-			UE_LOG(LogParkourMovement, Warning, TEXT("CHECK PASSED R"));
+			PARKOUR_LOG(LogParkourWallRun, Verbose, TEXT("CHECK PASSED R"));
 
+			PARKOUR_TRACE_PROBE_HIT();
 			return true;
 		}
 	}
 
-	UE_LOG(LogParkourMovement, Warning, TEXT("HIT R FAILED"));
-	UE_LOG(LogParkourMovement, Warning, TEXT("CHECK FAILED TRACE"));
+	PARKOUR_LOG(LogParkourWallRun, Verbose, TEXT("HIT R FAILED"));
+	PARKOUR_LOG(LogParkourWallRun, Verbose, TEXT("CHECK FAILED TRACE"));
 
 	return false;
 }
@@ -560,15 +1401,18 @@ FVector UParkourMovementComponent::PlayerToWallVector()
 
 bool UParkourMovementComponent::IsNextToWall(float vertical_tolerance)
 {
+	PARKOUR_SCOPE_CYCLE_COUNTER(STAT_ParkourIsNextToWall);
+	PARKOUR_TRACE_PROBE_SCOPE(CharacterOwner, EParkourProbe::IsNextToWall);
+
 	// Do a line trace from the player into the wall to make sure we're stil along the side of a wall
 	FVector crossVector = IsWallRunningL ? FVector(0.0f, 0.0f, -1.0f) : FVector(0.0f, 0.0f, 1.0f);
 	FVector traceStart = GetPawnOwner()->GetActorLocation() + (WallRunDirectionVector * 20.0f);
 	FVector traceEnd = traceStart + (FVector::CrossProduct(WallRunDirectionVector, crossVector) * 100);
 	FHitResult hitResult;
 
-	UE_LOG(LogParkourMovement, Warning, TEXT("CROSS VECTOR: %s"), *crossVector.ToString());
-	UE_LOG(LogParkourMovement, Warning, TEXT("WALL RUN DIRECTION VECTOR: %s"), *WallRunDirectionVector.ToString());
-	UE_LOG(LogParkourMovement, Warning, TEXT("Trace Start: %s,    Trace End: %s"), *traceStart.ToString(), *traceEnd.ToString());
+	PARKOUR_LOG(LogParkourWallRun, VeryVerbose, TEXT("CROSS VECTOR: %s"), *crossVector.ToString());
+	PARKOUR_LOG(LogParkourWallRun, VeryVerbose, TEXT("WALL RUN DIRECTION VECTOR: %s"), *WallRunDirectionVector.ToString());
+	PARKOUR_LOG(LogParkourWallRun, VeryVerbose, TEXT("Trace Start: %s,    Trace End: %s"), *traceStart.ToString(), *traceEnd.ToString());
 
 	// Required parameters for line traces
 	FCollisionQueryParams TraceParams;
@@ -578,7 +1422,7 @@ bool UParkourMovementComponent::IsNextToWall(float vertical_tolerance)
 	// Create a helper lambda for performing the line trace
 	auto lineTrace = [&](const FVector& start, const FVector& end)
 	{
-		return (GetWorld()->LineTraceSingleByChannel(hitResult, start, end, ECollisionChannel::ECC_Visibility, TraceParams));
+		return (ParkourLineTrace(hitResult, start, end, TraceParams));
 	};
 
 	// If a vertical tolerance was provided we want to do two line traces - one above and one below the calculated line
@@ -588,7 +1432,7 @@ bool UParkourMovementComponent::IsNextToWall(float vertical_tolerance)
 		if (lineTrace(FVector(traceStart.X, traceStart.Y, traceStart.Z + vertical_tolerance / 2.0f), FVector(traceEnd.X, traceEnd.Y, traceEnd.Z + vertical_tolerance / 2.0f)) == false &&
 			lineTrace(FVector(traceStart.X, traceStart.Y, traceStart.Z - vertical_tolerance / 2.0f), FVector(traceEnd.X, traceEnd.Y, traceEnd.Z - vertical_tolerance / 2.0f)) == false)
 		{
-			UE_LOG(LogParkourMovement, Warning, TEXT("NEXT TO WALL FAILED MULT TRACE"));
+			PARKOUR_LOG(LogParkourWallRun, VeryVerbose, TEXT("NEXT TO WALL FAILED MULT TRACE"));
 
 			return false;
 		}
@@ -599,20 +1443,20 @@ bool UParkourMovementComponent::IsNextToWall(float vertical_tolerance)
 		// return false if the line trace misses the wall
 		if (lineTrace(traceStart, traceEnd) == false)
 		{
-			UE_LOG(LogParkourMovement, Warning, TEXT("NEXT TO WALL FAILED SINGLE TRACE"));
+			PARKOUR_LOG(LogParkourWallRun, VeryVerbose, TEXT("NEXT TO WALL FAILED SINGLE TRACE"));
 
 			return false;
 		}
 	}
 
-	UE_LOG(LogParkourMovement, Warning, TEXT("WALL DISTANCE %f"), hitResult.Distance);
+	PARKOUR_LOG(LogParkourWallRun, VeryVerbose, TEXT("WALL DISTANCE %f"), hitResult.Distance);
 
 	if (hitResult.bBlockingHit)
-		UE_LOG(LogParkourMovement, Warning, TEXT("WALL HIT"));
+		PARKOUR_LOG(LogParkourWallRun, VeryVerbose, TEXT("WALL HIT"));
 
-	UE_LOG(LogParkourMovement, Warning, TEXT("WALL NAME %s"), *hitResult.GetComponent()->GetName());
+	PARKOUR_LOG(LogParkourWallRun, VeryVerbose, TEXT("WALL NAME %s"), *hitResult.GetComponent()->GetName());
 
-	UE_LOG(LogParkourMovement, Warning, TEXT("WR NORMAL %s"), *hitResult.Normal.ToString());
+	PARKOUR_LOG(LogParkourWallRun, VeryVerbose, TEXT("WR NORMAL %s"), *hitResult.Normal.ToString());
 
 	if (CheckWallRunTraces() == false)
 	{
@@ -625,18 +1469,77 @@ bool UParkourMovementComponent::IsNextToWall(float vertical_tolerance)
 	int newWallRunSide = FindWallRunSide(hitResult.ImpactNormal);
 	if (newWallRunSide == 0 && !IsWallRunningL)
 	{
-		UE_LOG(LogTemp, Warning, TEXT("NEXT TO WALL FAILED LEFT"));
+		PARKOUR_LOG(LogParkourWallRun, Verbose, TEXT("NEXT TO WALL FAILED LEFT"));
 
 		return false;
 	}
 	else if (newWallRunSide == 1 && !IsWallRunningR)
 	{
-		UE_LOG(LogTemp, Warning, TEXT("NEXT TO WALL FAILED RIGHT"));
+		PARKOUR_LOG(LogParkourWallRun, Verbose, TEXT("NEXT TO WALL FAILED RIGHT"));
+
+		return false;
+	}
+
+	PARKOUR_LOG(LogParkourWallRun, Verbose, TEXT("NEXT TO WALL PASSED %i"), newWallRunSide);
+
+	PARKOUR_TRACE_PROBE_HIT();
+	return true;
+}
+
+void UParkourMovementComponent::CacheWallPlane(const FHitResult& Hit)
+{
+	const UPrimitiveComponent* WallComponent = Hit.GetComponent();
+
+	if (WallComponent == nullptr)
+	{
+		WallPlane.Valid = false;
+		return;
+	}
+
+	WallPlane.Component = WallComponent;
+	WallPlane.Point = Hit.ImpactPoint;
+	WallPlane.Normal = Hit.ImpactNormal;
+	WallPlane.Distance = FVector::DotProduct(CharacterOwner->GetActorLocation() - Hit.ImpactPoint, Hit.ImpactNormal);
+	WallPlane.TraceMoveTime = MoveTimeSeconds;
+	WallPlane.Valid = true;
+}
+
+bool UParkourMovementComponent::IsNextToWallPlane()
+{
+	if (WallPlane.Valid == false || MoveTimeSeconds - WallPlane.TraceMoveTime >= WallPlaneRetraceTime || WallPlane.Component.IsValid() == false)
+	{
+		return false;
+	}
+
+	// Moving walls can't be tracked analytically
+	if (WallPlane.Component->Mobility == EComponentMobility::Movable)
+	{
+		return false;
+	}
+
+	const FVector Location = CharacterOwner->GetActorLocation();
+	const float Distance = FVector::DotProduct(Location - WallPlane.Point, WallPlane.Normal);
+
+	if (FMath::Abs(Distance - WallPlane.Distance) > WallPlaneDistanceTolerance)
+	{
+		return false;
+	}
+
+	// Only the face around the traced point is known to be there, further along the wall a trace has to decide
+	if (FVector::DistSquared(Location - WallPlane.Normal * Distance, WallPlane.Point) > FMath::Square(WallPlaneMaxDistance))
+	{
+		return false;
+	}
+
+	// Make sure the wall is still on the side the wall run started on, the same check IsNextToWall does through FindWallRunSide
+	const bool WallOnRight = FVector2D::DotProduct(FVector2D(WallPlane.Normal), FVector2D(GetPawnOwner()->GetActorRightVector())) > 0.0;
 
+	if (WallOnRight != IsWallRunningR)
+	{
 		return false;
 	}
 
-	UE_LOG(LogTemp, Warning, TEXT("NEXT TO WALL PASSED %i"), newWallRunSide);
+	INC_DWORD_STAT(STAT_ParkourWallPlaneCacheHits);
 
 	return true;
 }
@@ -685,14 +1588,17 @@ int UParkourMovementComponent::FindWallRunSide(const FVector& surface_normal)
 
 bool UParkourMovementComponent::BeginWallRun()
 {
-	UE_LOG(LogParkourMovement, Display, TEXT("BEGIN WALLRUN %i"), GetPawnOwner()->GetLocalRole());
+	PARKOUR_LOG(LogParkourWallRun, Log, TEXT("BEGIN WALLRUN %i"), GetPawnOwner()->GetLocalRole());
 
 	if (WantsToWallRun == true && !IsCustomMovementMode(ECustomMovementMode::CMOVE_WallRunning))
 	{
 		IsWallRunning = true;
+		WallPlane.Valid = false;
+
+		PARKOUR_TRACE_ACTION(CharacterOwner, EParkourAction::WallRun, true);
 
-		UE_LOG(LogParkourMovement, Display, TEXT("Begin Wall Run Forward Vector: %s"), *GetCharacterOwner()->GetActorForwardVector().ToString());
-		UE_LOG(LogParkourMovement, Display, TEXT("Begin Wall Run Impact Wall Normal: %s"), *WallRunImpactNormal.ToString());
+		PARKOUR_LOG(LogParkourWallRun, Log, TEXT("Begin Wall Run Forward Vector: %s"), *GetCharacterOwner()->GetActorForwardVector().ToString());
+		PARKOUR_LOG(LogParkourWallRun, Log, TEXT("Begin Wall Run Impact Wall Normal: %s"), *WallRunImpactNormal.ToString());
 
 		FRotator ControlRotation = PawnOwner->GetController()->GetControlRotation();
 
@@ -742,7 +1648,9 @@ bool UParkourMovementComponent::BeginWallRun()
 
 void UParkourMovementComponent::EndWallRun()
 {
-	UE_LOG(LogTemp, Display, TEXT("WALL RUN END %i"), GetPawnOwner()->GetLocalRole());
+	PARKOUR_TRACE_ACTION(CharacterOwner, EParkourAction::WallRun, false);
+
+	PARKOUR_LOG(LogParkourWallRun, Log, TEXT("WALL RUN END %i"), GetPawnOwner()->GetLocalRole());
 
 	SetMovementMode(EMovementMode::MOVE_Falling);
 
@@ -758,6 +1666,7 @@ void UParkourMovementComponent::EndWallRun()
 	IsWallRunning = false;
 	IsWallRunningL = false;
 	IsWallRunningR = false;
+	WallPlane.Valid = false;
 
 	SetCameraRotationLimit(-89.00002, 89.00002, -89.00002, 89.00002, 0, 359.98993);
 
@@ -769,7 +1678,10 @@ void UParkourMovementComponent::DoCustomJump()
 {
 	if (WantsToCustomJump)
 	{
-		UE_LOG(LogParkourMovement, Warning, TEXT("Custom Jump %i"), GetPawnOwner()->GetLocalRole());
+		PARKOUR_LOG(LogParkourMovement, Log, TEXT("Custom Jump %i"), GetPawnOwner()->GetLocalRole());
+
+		// The End* functions below reset the movement mode, so remember which mode the jump was made from
+		const uint8 JumpCustomMovementMode = CustomMovementMode;
 
 		if (IsWallRunning)
 		{
@@ -782,6 +1694,8 @@ void UParkourMovementComponent::DoCustomJump()
 			LaunchVelocity.Z = WallRunJumpHeight;
 
 			Launch(LaunchVelocity);
+
+			PARKOUR_TRACE_CUSTOM_JUMP(CharacterOwner, JumpCustomMovementMode, LaunchVelocity);
 		}
 		else if (IsVerticalWallRunning)
 		{
@@ -801,7 +1715,9 @@ void UParkourMovementComponent::DoCustomJump()
 
 			Launch(LaunchVelocity);
 
-			UE_LOG(LogParkourMovement, Warning, TEXT("Wall Run Jump Velocity: %s"), *LaunchVelocity.ToString());
+			PARKOUR_TRACE_CUSTOM_JUMP(CharacterOwner, JumpCustomMovementMode, LaunchVelocity);
+
+			PARKOUR_LOG(LogParkourMovement, Log, TEXT("Wall Run Jump Velocity: %s"), *LaunchVelocity.ToString());
 		}
 		else if (IsClimbingLadder)
 		{
@@ -815,7 +1731,9 @@ void UParkourMovementComponent::DoCustomJump()
 
 			Launch(LaunchVelocity);
 
-			UE_LOG(LogParkourMovement, Warning, TEXT("Ladder Jump Velocity %s %i"), *LaunchVelocity.ToString(), GetPawnOwner()->GetLocalRole());
+			PARKOUR_TRACE_CUSTOM_JUMP(CharacterOwner, JumpCustomMovementMode, LaunchVelocity);
+
+			PARKOUR_LOG(LogParkourMovement, Log, TEXT("Ladder Jump Velocity %s %i"), *LaunchVelocity.ToString(), GetPawnOwner()->GetLocalRole());
 		}
 		else if (IsLedgeHanging)
 		{
@@ -829,7 +1747,9 @@ void UParkourMovementComponent::DoCustomJump()
 
 			Launch(LaunchVelocity);
 
-			UE_LOG(LogParkourMovement, Warning, TEXT("Ledge Hang Jump Velocity %s %i"), *LaunchVelocity.ToString(), GetPawnOwner()->GetLocalRole());
+			PARKOUR_TRACE_CUSTOM_JUMP(CharacterOwner, JumpCustomMovementMode, LaunchVelocity);
+
+			PARKOUR_LOG(LogParkourMovement, Log, TEXT("Ledge Hang Jump Velocity %s %i"), *LaunchVelocity.ToString(), GetPawnOwner()->GetLocalRole());
 		}
 	}
 }
@@ -840,25 +1760,27 @@ void UParkourMovementComponent::DoCustomJump()
 
 bool UParkourMovementComponent::CheckCanVerticalWallRun(const FHitResult Hit)
 {
-	UE_LOG(LogParkourMovement, Warning, TEXT("Check Vertical Wall Run"));
+	PARKOUR_TRACE_PROBE_SCOPE(CharacterOwner, EParkourProbe::CheckCanVerticalWallRun);
+
+	PARKOUR_LOG(LogParkourWallRun, Verbose, TEXT("Check Vertical Wall Run"));
 
 	if (WantsToVerticalWallRun == false)
 	{
-		UE_LOG(LogParkourMovement, Warning, TEXT("Vertical Wall Run Check Failed: Key Not Down"));
+		PARKOUR_LOG(LogParkourWallRun, Verbose, TEXT("Vertical Wall Run Check Failed: Key Not Down"));
 
 		return false;
 	}
 
 	if (MovementMode != EMovementMode::MOVE_Walking)
 	{
-		UE_LOG(LogParkourMovement, Warning, TEXT("Vertical Wall Run Check Failed: Not Walking"));
+		PARKOUR_LOG(LogParkourWallRun, Verbose, TEXT("Vertical Wall Run Check Failed: Not Walking"));
 
 		return false;
 	}
 
 	if (CanSurfaceBeWallRan(Hit.ImpactNormal) == false)
 	{
-		UE_LOG(LogParkourMovement, Warning, TEXT("Vertical Wall Run Check Failed: Wall Angle"));
+		PARKOUR_LOG(LogParkourWallRun, Verbose, TEXT("Vertical Wall Run Check Failed: Wall Angle"));
 
 		return false;
 	}
@@ -870,8 +1792,9 @@ bool UParkourMovementComponent::CheckCanVerticalWallRun(const FHitResult Hit)
 
 	BeginVerticalWallRun();
 
-	UE_LOG(LogParkourMovement, Warning, TEXT("Vertical Wall Run Check Passed"));
+	PARKOUR_LOG(LogParkourWallRun, Verbose, TEXT("Vertical Wall Run Check Passed"));
 
+	PARKOUR_TRACE_PROBE_HIT();
 	return true;
 }
 
@@ -886,7 +1809,7 @@ bool UParkourMovementComponent::CheckVerticalWallRunTraces()
 	FHitResult HitLow;
 	FVector TraceStart = CharacterOwner->GetActorLocation();
 	FVector TraceEnd = TraceStart + (CharacterOwner->GetActorForwardVector() * 75);
-	GetWorld()->LineTraceSingleByChannel(HitLow, TraceStart, TraceEnd, ECC_Visibility, TraceParams);
+	ParkourLineTrace(HitLow, TraceStart, TraceEnd, TraceParams);
 
 	if (DrawDebug)
 	{
@@ -895,7 +1818,7 @@ bool UParkourMovementComponent::CheckVerticalWallRunTraces()
 
 	if (HitLow.bBlockingHit == false)
 	{
-		UE_LOG(LogParkourMovement, Warning, TEXT("Check Vertical Wall Run Low Trace Failed"));
+		PARKOUR_LOG(LogParkourWallRun, Verbose, TEXT("Check Vertical Wall Run Low Trace Failed"));
 
 		return false;
 	}
@@ -917,7 +1840,7 @@ bool UParkourMovementComponent::CheckVerticalWallRunTraces()
 	TraceStart = CharacterOwner->GetActorLocation();
 	TraceStart.Z += CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleHalfHeight();
 	TraceEnd = TraceStart + (CharacterOwner->GetActorForwardVector() * (75 + TraceEndDistance));
-	GetWorld()->LineTraceSingleByChannel(HitHigh, TraceStart, TraceEnd, ECC_Visibility, TraceParams);
+	ParkourLineTrace(HitHigh, TraceStart, TraceEnd, TraceParams);
 
 	if (DrawDebug)
 	{
@@ -926,7 +1849,7 @@ bool UParkourMovementComponent::CheckVerticalWallRunTraces()
 
 	if (HitHigh.bBlockingHit == false)
 	{
-		UE_LOG(LogParkourMovement, Warning, TEXT("Check Vertical Wall Run High Trace Failed"));
+		PARKOUR_LOG(LogParkourWallRun, Verbose, TEXT("Check Vertical Wall Run High Trace Failed"));
 
 		return false;
 	}
@@ -938,13 +1861,15 @@ bool UParkourMovementComponent::CheckVerticalWallRunTraces()
 
 bool UParkourMovementComponent::BeginVerticalWallRun()
 {
-	UE_LOG(LogParkourMovement, Warning, TEXT("Begin Vertical Wall Run %i"), GetPawnOwner()->GetLocalRole());
+	PARKOUR_LOG(LogParkourWallRun, Log, TEXT("Begin Vertical Wall Run %i"), GetPawnOwner()->GetLocalRole());
 
 	if (WantsToVerticalWallRun == true && !IsCustomMovementMode(ECustomMovementMode::CMOVE_VerticalWallRunning))
 	{
 		IsVerticalWallRunning = true;
 		IsFacingTowardsWall = true;
 
+		PARKOUR_TRACE_ACTION(CharacterOwner, EParkourAction::VerticalWallRun, true);
+
 		static_cast<AParkourFPSCharacter*>(GetCharacterOwner())->PlayVerticalWallRunMontage();
 
 		GetParkourFPSCharacter()->bAcceptingMovementInput = false;
@@ -965,6 +1890,8 @@ bool UParkourMovementComponent::BeginVerticalWallRun()
 
 void UParkourMovementComponent::EndVerticalWallRun()
 {
+	PARKOUR_TRACE_ACTION(CharacterOwner, EParkourAction::VerticalWallRun, false);
+
 	IsVerticalWallRunning = false;
 	IsFacingTowardsWall = false;
 	IsRotatingAwayFromWall = false;
@@ -995,26 +1922,26 @@ bool UParkourMovementComponent::CheckCanSlide()
 
 		if (!IsWalkingForward())
 		{
-			UE_LOG(LogParkourMovement, Warning, TEXT("Slide Check Failed: Not Walking Forward"));
+			PARKOUR_LOG(LogParkourSlide, Verbose, TEXT("Slide Check Failed: Not Walking Forward"));
 
 			return false;
 		}
 
 		if (MovementMode != EMovementMode::MOVE_Walking)
 		{
-			UE_LOG(LogParkourMovement, Warning, TEXT("Slide Check Failed: Movement Mode Not Walking"));
+			PARKOUR_LOG(LogParkourSlide, Verbose, TEXT("Slide Check Failed: Movement Mode Not Walking"));
 
 			return false;
 		}
 
-		UE_LOG(LogParkourMovement, Warning, TEXT("Slide Check Passed"));
+		PARKOUR_LOG(LogParkourSlide, Verbose, TEXT("Slide Check Passed"));
 
 		return true;
 	}
 
 	return false;
 
-	UE_LOG(LogParkourMovement, Warning, TEXT("Slide Check Failed: Too Low Local Role"));
+	PARKOUR_LOG(LogParkourSlide, Verbose, TEXT("Slide Check Failed: Too Low Local Role"));
 }
 
 bool UParkourMovementComponent::CanStandUp()
@@ -1029,11 +1956,13 @@ bool UParkourMovementComponent::CanStandUpLineTrace(FVector CharacterFeetLocatio
 
 void UParkourMovementComponent::BeginSlide()
 {
-	UE_LOG(LogParkourMovement, Warning, TEXT("BEGIN SLIDE"));
+	PARKOUR_TRACE_ACTION(CharacterOwner, EParkourAction::Slide, true);
+
+	PARKOUR_LOG(LogParkourSlide, Log, TEXT("BEGIN SLIDE"));
 
 	if (WantsToSlide == true && !IsSliding)
 	{
-		//SetMovementMode(EMovementMode::MOVE_Custom, ECustomMovementMode::CMOVE_Sliding);
+		SetMovementMode(EMovementMode::MOVE_Custom, ECustomMovementMode::CMOVE_Sliding);
 	}
 	
 	IsCrouched = true;
@@ -1051,11 +1980,18 @@ void UParkourMovementComponent::BeginSlide()
 
 void UParkourMovementComponent::EndSlide()
 {
-	SetMovementMode(EMovementMode::MOVE_Walking);
+	PARKOUR_TRACE_ACTION(CharacterOwner, EParkourAction::Slide, false);
 
+	// Cleared before the mode change so OnMovementModeChanged doesn't end the slide a second time
 	IsCrouched = false;
 	IsSliding = false;
 
+	// A slide that ended by falling or jumping keeps that mode
+	if (IsCustomMovementMode(ECustomMovementMode::CMOVE_Sliding))
+	{
+		SetMovementMode(EMovementMode::MOVE_Walking);
+	}
+
 	WantsToSlide = false;
 	MovementKey2Down = false;
 
@@ -1102,7 +2038,9 @@ FVector UParkourMovementComponent::CalculateFloorInfluence(FVector FloorNormal)
 
 bool UParkourMovementComponent::CheckCanZipline(AActor* HitActor)
 {
-	UE_LOG(LogParkourMovement, Warning, TEXT("Zipline Checks"));
+	PARKOUR_TRACE_PROBE_SCOPE(CharacterOwner, EParkourProbe::CheckCanZipline);
+
+	PARKOUR_LOG(LogParkourZipline, Verbose, TEXT("Zipline Checks"));
 
 	if (IsCustomMovementMode(ECustomMovementMode::CMOVE_Ziplining))
 	{
@@ -1119,12 +2057,15 @@ bool UParkourMovementComponent::CheckCanZipline(AActor* HitActor)
 		WantsToZiplineLadder = true;
 	}
 
+	CurrentZipline = static_cast<AZipline*>(HitActor);
+
 	ZiplineStart = static_cast<AZipline*>(HitActor)->StartPoint;
 	ZiplineEnd = static_cast<AZipline*>(HitActor)->EndPoint;
 	ZiplineDirection = static_cast<AZipline*>(HitActor)->GetZiplineDirection();
 
 	BeginZipline();
 
+	PARKOUR_TRACE_PROBE_HIT();
 	return true;
 }
 
@@ -1132,10 +2073,13 @@ void UParkourMovementComponent::BeginZipline()
 {
 	if (!IsCustomMovementMode(ECustomMovementMode::CMOVE_Ziplining))
 	{
+		// Only a real begin is traced, the begin checks run again while already in the mode
+		PARKOUR_TRACE_ACTION(CharacterOwner, EParkourAction::Zipline, true);
+
 		IsZiplining = true;
 	}
 
-	UE_LOG(LogParkourMovement, Warning, TEXT("Zipline Begin"));
+	PARKOUR_LOG(LogParkourZipline, Log, TEXT("Zipline Begin"));
 
 	GetParkourFPSCharacter()->PlayZiplineMontage();
 
@@ -1152,13 +2096,17 @@ void UParkourMovementComponent::BeginZipline()
 
 void UParkourMovementComponent::EndZipline()
 {
+	PARKOUR_TRACE_ACTION(CharacterOwner, EParkourAction::Zipline, false);
+
+	ClearRailAnchor();
+
 	WantsToZiplineLadder = false;
 	
 	IsZiplining = false;
 
 	MovementMode = EMovementMode::MOVE_Falling;
 
-	UE_LOG(LogParkourMovement, Warning, TEXT("Zipline End"));
+	PARKOUR_LOG(LogParkourZipline, Log, TEXT("Zipline End"));
 
 	GetParkourFPSCharacter()->EndZiplineMontage();
 
@@ -1174,6 +2122,8 @@ void UParkourMovementComponent::EndZipline()
 
 bool UParkourMovementComponent::CheckCanClimbLadder()
 {
+	PARKOUR_TRACE_PROBE_SCOPE(CharacterOwner, EParkourProbe::CheckCanClimbLadder);
+
 	if (IsCustomMovementMode(ECustomMovementMode::CMOVE_ClimbLadder))
 	{
 		return false;
@@ -1192,7 +2142,7 @@ bool UParkourMovementComponent::CheckCanClimbLadder()
 	FHitResult Hit;
 	FVector TraceStart = CharacterOwner->GetActorLocation();
 	FVector TraceEnd = TraceStart + (CharacterOwner->GetActorForwardVector() * 75);
-	GetWorld()->LineTraceSingleByChannel(Hit, TraceStart, TraceEnd, ECC_Visibility, TraceParams);
+	ParkourLineTrace(Hit, TraceStart, TraceEnd, TraceParams);
 
 	if (DrawDebug)
 	{
@@ -1216,6 +2166,7 @@ bool UParkourMovementComponent::CheckCanClimbLadder()
 
 	BeginClimbLadder();
 
+	PARKOUR_TRACE_PROBE_HIT();
 	return true;
 }
 
@@ -1223,10 +2174,13 @@ void UParkourMovementComponent::BeginClimbLadder()
 {
 	if (!IsCustomMovementMode(ECustomMovementMode::CMOVE_ClimbLadder))
 	{
+		// Only a real begin is traced, the begin checks run again while already in the mode
+		PARKOUR_TRACE_ACTION(CharacterOwner, EParkourAction::ClimbLadder, true);
+
 		IsClimbingLadder = true;
 	}
 
-	UE_LOG(LogParkourMovement, Warning, TEXT("Climb Ladder Begin %i"), GetPawnOwner()->GetLocalRole());
+	PARKOUR_LOG(LogParkourLadder, Log, TEXT("Climb Ladder Begin %i"), GetPawnOwner()->GetLocalRole());
 
 	GetParkourFPSCharacter()->bAcceptingMovementInput = false;
 	GetParkourFPSCharacter()->bUseControllerRotationYaw = false;
@@ -1242,6 +2196,10 @@ void UParkourMovementComponent::BeginClimbLadder()
 
 void UParkourMovementComponent::EndClimbLadder()
 {
+	PARKOUR_TRACE_ACTION(CharacterOwner, EParkourAction::ClimbLadder, false);
+
+	ClearRailAnchor();
+
 	WantsToZiplineLadder = false;
 
 	IsClimbingLadder = false;
@@ -1250,7 +2208,7 @@ void UParkourMovementComponent::EndClimbLadder()
 
 	static_cast<AParkourFPSCharacter*>(GetCharacterOwner())->EndLadderMontage();
 
-	UE_LOG(LogParkourMovement, Warning, TEXT("Climb Ladder End %i"), GetPawnOwner()->GetLocalRole());
+	PARKOUR_LOG(LogParkourLadder, Log, TEXT("Climb Ladder End %i"), GetPawnOwner()->GetLocalRole());
 
 	GetParkourFPSCharacter()->bAcceptingMovementInput = true;
 	GetParkourFPSCharacter()->bUseControllerRotationYaw = true;
@@ -1262,6 +2220,53 @@ void UParkourMovementComponent::EndClimbLadder()
 
 #pragma region Climbing Functions
 
+void UParkourMovementComponent::RunLedgeProbes()
+{
+	bool LedgeHang = CheckCanHangLedge();
+
+	if (LedgeHang)
+	{
+		PARKOUR_LOG(LogParkourLedge, Verbose, TEXT("Actor Hit Ledge Grab TRUE"));
+	}
+	else
+	{
+		PARKOUR_LOG(LogParkourLedge, Verbose, TEXT("Actor Hit Ledge Grab FALSE"));
+	}
+
+	bool LedgeClimb = CheckCanClimb();
+
+	if (LedgeClimb)
+	{
+		PARKOUR_LOG(LogParkourLedge, Verbose, TEXT("Actor Hit Ledge Climb TRUE"));
+	}
+	else
+	{
+		PARKOUR_LOG(LogParkourLedge, Verbose, TEXT("Actor Hit Ledge Climb FALSE"));
+	}
+
+	bool LedgeQuickClimb = CheckCanQuickClimb();
+
+	if (LedgeQuickClimb)
+	{
+		PARKOUR_LOG(LogParkourLedge, Verbose, TEXT("Actor Hit Ledge Quick Climb TRUE"));
+
+		bool LedgeVault = CheckCanVault();
+
+		if (LedgeVault)
+		{
+			PARKOUR_LOG(LogParkourLedge, Verbose, TEXT("Actor Hit Ledge Vault TRUE"));
+		}
+		else
+		{
+			PARKOUR_LOG(LogParkourLedge, Verbose, TEXT("Actor Hit Ledge Vault FALSE"));
+		}
+	}
+	else
+	{
+		PARKOUR_LOG(LogParkourLedge, Verbose, TEXT("Actor Hit Ledge Quick Climb FALSE"));
+	}
+}
+
 ELedgeState UParkourMovementComponent::GetStateOfLedge()
 {
 	ELedgeState LedgeState = ELedgeState::STATE_None;
@@ -1274,141 +2279,156 @@ ELedgeState UParkourMovementComponent::GetStateOfLedge()
 	return LedgeState;
 }
 
-bool UParkourMovementComponent::CheckCanHangLedge()
+const FParkourLedgeProbe& UParkourMovementComponent::GetLedgeProbe()
 {
-	FVector TraceStart = CharacterOwner->GetActorLocation() + (CharacterOwner->GetActorForwardVector() * 70.0);
+	const FVector Location = CharacterOwner->GetActorLocation();
+	const FVector Forward = CharacterOwner->GetActorForwardVector();
+
+	// OnActorHit can ask for the probe part way through a move, after the capsule has moved or turned since the probe was traced
+	if (LedgeProbe.Valid && LedgeProbe.Location.Equals(Location) && LedgeProbe.Forward.Equals(Forward))
+	{
+		return LedgeProbe;
+	}
+
+	FVector TraceStart = Location + (Forward * 70.0);
 	TraceStart.Z += CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleHalfHeight();
 
-	FVector TraceEnd = CharacterOwner->GetActorLocation() + (CharacterOwner->GetActorForwardVector() * 70.0);
+	FVector TraceEnd = Location + (Forward * 70.0);
 	TraceEnd.Z -= CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleHalfHeight();
 
-	FHitResult HitLow;
 	FCollisionQueryParams TraceParams;
 	TraceParams.AddIgnoredActor(CharacterOwner);
 
-	bool SurfaceFoundLow = GetWorld()->LineTraceSingleByChannel(HitLow, TraceStart, TraceEnd, ECC_Visibility, TraceParams);
-
-	if (SurfaceFoundLow)
-	{
-		UE_LOG(LogParkourMovement, Warning, TEXT("LEDGE HANG LOW HIT"));
-	}
-	else
-	{
-		UE_LOG(LogParkourMovement, Warning, TEXT("LEDGE HANG LOW NOT HIT"));
-	}
+	LedgeProbe = FParkourLedgeProbe();
+	LedgeProbe.Valid = true;
+	LedgeProbe.Location = Location;
+	LedgeProbe.Forward = Forward;
+	LedgeProbe.SurfaceFound = ParkourLineTrace(LedgeProbe.Hit, TraceStart, TraceEnd, TraceParams);
+	LedgeProbe.SurfaceHeight = LedgeProbe.Hit.Location.Z - LedgeProbe.Hit.TraceEnd.Z;
 
 	if (DrawDebug)
 	{
 		DrawDebugLine(GetWorld(), TraceStart, TraceEnd, FColor::Magenta, true, 1, 0, 2);
 	}
 
-	if (HitLow.bBlockingHit == false)
+	return LedgeProbe;
+}
+
+bool UParkourMovementComponent::GetLedgeProbeClearance()
+{
+	const FParkourLedgeProbe& Probe = GetLedgeProbe();
+
+	if (!Probe.ClearanceChecked)
 	{
-		return false;
+		LedgeProbe.ClearanceChecked = true;
+		LedgeProbe.Clear = Probe.SurfaceFound && CheckCanClimbToHit(Probe.Hit);
 	}
 
-	LedgeHeight = HitLow.Location.Z;
+	return LedgeProbe.Clear;
+}
 
-	// Make sure that the surface is at an appropriate height
-	float SurfaceHeight = HitLow.Location.Z - HitLow.TraceEnd.Z;
+const FVector& UParkourMovementComponent::GetLedgeProbeWallNormal()
+{
+	const FParkourLedgeProbe& Probe = GetLedgeProbe();
 
-	if (SurfaceHeight < MinClimbHeight || SurfaceHeight > MaxClimbHeight)
+	if (!Probe.WallNormalChecked)
 	{
-		UE_LOG(LogParkourMovement, Warning, TEXT("LEDGE HANG HEIGHT FAILED"));
+		FVector TraceStart = Probe.Location;
+		FVector TraceEnd = TraceStart + (Probe.Forward * 100);
+		FHitResult HitLedgeNormal;
+		FCollisionQueryParams TraceParams;
+		TraceParams.AddIgnoredActor(CharacterOwner);
 
-		return false;
+		ParkourLineTrace(HitLedgeNormal, TraceStart, TraceEnd, TraceParams);
+
+		LedgeProbe.WallNormalChecked = true;
+		LedgeProbe.WallNormal = HitLedgeNormal.ImpactNormal;
 	}
 
-	TraceEnd = HitLow.ImpactPoint;
-	TraceEnd.Z += 1;
-	FHitResult HitHi;
+	return LedgeProbe.WallNormal;
+}
 
-	bool SurfaceFoundHigh = GetWorld()->LineTraceSingleByChannel(HitHi, TraceStart, TraceEnd, ECC_Visibility, TraceParams);
+bool UParkourMovementComponent::CheckCanHangLedge()
+{
+	PARKOUR_SCOPE_CYCLE_COUNTER(STAT_ParkourCheckCanHangLedge);
+	PARKOUR_TRACE_PROBE_SCOPE(CharacterOwner, EParkourProbe::CheckCanHangLedge);
 
-	if (DrawDebug)
-	{
-		DrawDebugLine(GetWorld(), TraceStart, TraceEnd, FColor::Red, true, 1, 0, 2);
-	}
+	const FParkourLedgeProbe& Probe = GetLedgeProbe();
 
-	if (SurfaceFoundHigh)
+	if (Probe.SurfaceFound)
 	{
-		UE_LOG(LogParkourMovement, Warning, TEXT("LEDGE HANG HIGH HIT"));
+		PARKOUR_LOG(LogParkourLedge, Verbose, TEXT("LEDGE HANG LOW HIT"));
 	}
 	else
 	{
-		UE_LOG(LogParkourMovement, Warning, TEXT("LEDGE HANG HIGH NOT HIT"));
+		PARKOUR_LOG(LogParkourLedge, Verbose, TEXT("LEDGE HANG LOW NOT HIT"));
 	}
 
-	if (HitHi.bBlockingHit)
+	if (Probe.Hit.bBlockingHit == false)
 	{
 		return false;
 	}
 
-	if (HitLow.Normal.Z < GetWalkableFloorZ())
+	LedgeHeight = Probe.Hit.Location.Z;
+
+	// Make sure that the surface is at an appropriate height
+	if (Probe.SurfaceHeight < MinClimbHeight || Probe.SurfaceHeight > MaxClimbHeight)
 	{
+		PARKOUR_LOG(LogParkourLedge, Verbose, TEXT("LEDGE HANG HEIGHT FAILED"));
+
 		return false;
 	}
 
-	// Save the direction of the wall/ledge facing towards the character, used for setting camera rotation limits
-	TraceStart = GetCharacterOwner()->GetActorLocation();
-	TraceEnd = TraceStart + (GetCharacterOwner()->GetActorForwardVector() * 100);
-	FHitResult HitLedgeNormal;
+	// A second trace from the same start down to just above the impact point can't hit anything the probe didn't hit first,
+	// so there is always open space above the ledge here
 
-	bool LedgeWasHit = GetWorld()->LineTraceSingleByChannel(HitLedgeNormal, TraceStart, TraceEnd, ECC_Visibility, TraceParams);
+	if (Probe.Hit.Normal.Z < GetWalkableFloorZ())
+	{
+		return false;
+	}
 
-	LedgeNormal = HitLedgeNormal.ImpactNormal;
+	// Save the direction of the wall/ledge facing towards the character, used for setting camera rotation limits
+	LedgeNormal = GetLedgeProbeWallNormal();
 
+	PARKOUR_TRACE_PROBE_HIT();
 	return true;
 }
 
 bool UParkourMovementComponent::CheckCanClimb()
 {
-	FVector TraceStart = CharacterOwner->GetActorLocation() + (CharacterOwner->GetActorForwardVector() * 70.0);
-	TraceStart.Z += CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleHalfHeight();
-
-	FVector TraceEnd = CharacterOwner->GetActorLocation() + (CharacterOwner->GetActorForwardVector() * 70.0);
-	TraceEnd.Z -= CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleHalfHeight();
-
-	FHitResult Hit;
-	FCollisionQueryParams TraceParams;
-	TraceParams.AddIgnoredActor(CharacterOwner);
+	PARKOUR_SCOPE_CYCLE_COUNTER(STAT_ParkourCheckCanClimb);
+	PARKOUR_TRACE_PROBE_SCOPE(CharacterOwner, EParkourProbe::CheckCanClimb);
 
-	bool SurfaceFound = GetWorld()->LineTraceSingleByChannel(Hit, TraceStart, TraceEnd, ECC_Visibility, TraceParams);
-
-	if (DrawDebug)
-	{
-		DrawDebugLine(GetWorld(), TraceStart, TraceEnd, FColor::Blue, true, 1, 0, 2);
-	}
+	const FParkourLedgeProbe& Probe = GetLedgeProbe();
 
-	if (SurfaceFound == false)
+	if (Probe.SurfaceFound == false)
 	{
-		UE_LOG(LogParkourMovement, Warning, TEXT("Check Can Climb Failed No Surface"));
+		PARKOUR_LOG(LogParkourLedge, Verbose, TEXT("Check Can Climb Failed No Surface"));
 
 		return false;
 	}
 	else
 	{
 		// Make sure that the surface is at an appropriate height
-		float SurfaceHeight = Hit.Location.Z - Hit.TraceEnd.Z;
-
-		if (SurfaceHeight < MinClimbHeight || SurfaceHeight > MaxClimbHeight)
+		if (Probe.SurfaceHeight < MinClimbHeight || Probe.SurfaceHeight > MaxClimbHeight)
 		{
-			UE_LOG(LogParkourMovement, Warning, TEXT("Climb not at correct height"));
+			PARKOUR_LOG(LogParkourLedge, Verbose, TEXT("Climb not at correct height"));
 
 			return false;
 		}
 
 
-		if (CheckCanClimbToHit(Hit) == false)
+		if (GetLedgeProbeClearance() == false)
 		{
-			UE_LOG(LogParkourMovement, Warning, TEXT("Check Can Climb Failed Can't Climb To Hit"));
+			PARKOUR_LOG(LogParkourLedge, Verbose, TEXT("Check Can Climb Failed Can't Climb To Hit"));
 
 			return false;
 		}
 	}
 
-	UE_LOG(LogParkourMovement, Warning, TEXT("Check Can Climb Passed"));
+	PARKOUR_LOG(LogParkourLedge, Verbose, TEXT("Check Can Climb Passed"));
 
+	PARKOUR_TRACE_PROBE_HIT();
 	return true;
 }
 
@@ -1417,7 +2437,7 @@ bool UParkourMovementComponent::CheckCanClimbToHit(FHitResult Hit)
 	// Make sure the surface thats being climbed to is at a walkable angle
 	if (Hit.Normal.Z < GetWalkableFloorZ())
 	{
-		UE_LOG(LogParkourMovement, Warning, TEXT("CLIMB SURFACE IS NOT WALKABLE"));
+		PARKOUR_LOG(LogParkourLedge, Verbose, TEXT("CLIMB SURFACE IS NOT WALKABLE"));
 
 		return false;
 	}
@@ -1432,7 +2452,7 @@ bool UParkourMovementComponent::CheckCanClimbToHit(FHitResult Hit)
 	FCollisionQueryParams TraceParams;
 	TraceParams.AddIgnoredActor(CharacterOwner);
 
-	bool ActorHit = GetWorld()->SweepSingleByChannel(ClearHit, EndLocation, EndLocation, FQuat::Identity, ECC_Visibility,
+	bool ActorHit = ParkourSweep(ClearHit, EndLocation, EndLocation,
 	FCollisionShape::MakeCapsule(CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleRadius(), CapsuleHalfHeight), TraceParams);
 
 	if (DrawDebug)
@@ -1445,8 +2465,8 @@ bool UParkourMovementComponent::CheckCanClimbToHit(FHitResult Hit)
 
 	if (ActorHit)
 	{
-		UE_LOG(LogTemp, Warning, TEXT("CLIMB SURFACE NOT CLEAR"));
-		UE_LOG(LogTemp, Warning, TEXT("Climb Clear Actor Hit: %s"), *ClearHit.GetActor()->GetName());
+		PARKOUR_LOG(LogParkourLedge, Verbose, TEXT("CLIMB SURFACE NOT CLEAR"));
+		PARKOUR_LOG(LogParkourLedge, Verbose, TEXT("Climb Clear Actor Hit: %s"), *ClearHit.GetActor()->GetName());
 
 		return false;
 	}
@@ -1456,62 +2476,52 @@ bool UParkourMovementComponent::CheckCanClimbToHit(FHitResult Hit)
 
 bool UParkourMovementComponent::CheckCanQuickClimb()
 {
+	PARKOUR_SCOPE_CYCLE_COUNTER(STAT_ParkourCheckCanQuickClimb);
+	PARKOUR_TRACE_PROBE_SCOPE(CharacterOwner, EParkourProbe::CheckCanQuickClimb);
+
 	if (MovementMode != EMovementMode::MOVE_Walking || IsSliding)
 	{
 		return false;
 	}
 
-	FVector TraceStart = CharacterOwner->GetActorLocation() + (CharacterOwner->GetActorForwardVector() * 70.0);
-	TraceStart.Z += CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleHalfHeight();
-
-	FVector TraceEnd = CharacterOwner->GetActorLocation() + (CharacterOwner->GetActorForwardVector() * 70.0);
-	TraceEnd.Z -= CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleHalfHeight();
-
-	FHitResult Hit;
-	FCollisionQueryParams TraceParams;
-	TraceParams.AddIgnoredActor(CharacterOwner);
-
-	bool SurfaceFound = GetWorld()->LineTraceSingleByChannel(Hit, TraceStart, TraceEnd, ECC_Visibility, TraceParams);
+	const FParkourLedgeProbe& Probe = GetLedgeProbe();
 
-	if (DrawDebug)
-	{
-		DrawDebugLine(GetWorld(), TraceStart, TraceEnd, FColor::Yellow, true, 1, 0, 2);
-	}
-
-	if (SurfaceFound == false)
+	if (Probe.SurfaceFound == false)
 	{
-		UE_LOG(LogParkourMovement, Warning, TEXT("Check Can Quick Climb Failed No Surface"));
+		PARKOUR_LOG(LogParkourLedge, Verbose, TEXT("Check Can Quick Climb Failed No Surface"));
 
 		return false;
 	}
 	else
 	{
 		// Make sure that the surface is at an appropriate height
-		float SurfaceHeight = Hit.Location.Z - Hit.TraceEnd.Z;
-
-		if (SurfaceHeight < MinQuickClimbHeight || SurfaceHeight > MaxQuickClimbHeight)
+		if (Probe.SurfaceHeight < MinQuickClimbHeight || Probe.SurfaceHeight > MaxQuickClimbHeight)
 		{
-			UE_LOG(LogParkourMovement, Warning, TEXT("Climb not at correct height"));
+			PARKOUR_LOG(LogParkourLedge, Verbose, TEXT("Climb not at correct height"));
 
 			return false;
 		}
 
 
-		if (CheckCanClimbToHit(Hit) == false)
+		if (GetLedgeProbeClearance() == false)
 		{
-			UE_LOG(LogParkourMovement, Warning, TEXT("Check Can Quick Climb Failed Can't Climb To Hit"));
+			PARKOUR_LOG(LogParkourLedge, Verbose, TEXT("Check Can Quick Climb Failed Can't Climb To Hit"));
 
 			return false;
 		}
 	}
 
-	UE_LOG(LogParkourMovement, Warning, TEXT("Check Can Quick Climb Passed"));
+	PARKOUR_LOG(LogParkourLedge, Verbose, TEXT("Check Can Quick Climb Passed"));
 
+	PARKOUR_TRACE_PROBE_HIT();
 	return true;
 }
 
 bool UParkourMovementComponent::CheckCanVault()
 {
+	PARKOUR_SCOPE_CYCLE_COUNTER(STAT_ParkourCheckCanVault);
+	PARKOUR_TRACE_PROBE_SCOPE(CharacterOwner, EParkourProbe::CheckCanVault);
+
 	float CapsuleRadius = CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleRadius();
 
 	FVector TraceStart = CharacterOwner->GetActorLocation() + (CharacterOwner->GetActorForwardVector() * (CapsuleRadius + MaxQuickClimbWallWidth + 10));
@@ -1524,7 +2534,7 @@ bool UParkourMovementComponent::CheckCanVault()
 	FCollisionQueryParams TraceParams;
 	TraceParams.AddIgnoredActor(CharacterOwner);
 
-	bool SurfaceFound = GetWorld()->LineTraceSingleByChannel(Hit, TraceStart, TraceEnd, ECC_Visibility, TraceParams);
+	bool SurfaceFound = ParkourLineTrace(Hit, TraceStart, TraceEnd, TraceParams);
 
 	if (DrawDebug)
 	{
@@ -1536,12 +2546,15 @@ bool UParkourMovementComponent::CheckCanVault()
 		return false;
 	}
 
+	PARKOUR_TRACE_PROBE_HIT();
 	return true;
 }
 
 void UParkourMovementComponent::BeginLedgeHang()
 {
-	UE_LOG(LogParkourMovement, Warning, TEXT("Begin Ledge Hang %i"), PawnOwner->GetLocalRole());
+	PARKOUR_TRACE_ACTION(CharacterOwner, EParkourAction::LedgeHang, true);
+
+	PARKOUR_LOG(LogParkourLedge, Log, TEXT("Begin Ledge Hang %i"), PawnOwner->GetLocalRole());
 
 	SetMovementMode(EMovementMode::MOVE_Custom, ECustomMovementMode::CMOVE_LedgeHang);
 
@@ -1567,7 +2580,9 @@ void UParkourMovementComponent::BeginLedgeHang()
 
 void UParkourMovementComponent::EndLedgeHang()
 {
-	UE_LOG(LogParkourMovement, Warning, TEXT("End Ledge Hang %i"), PawnOwner->GetLocalRole());
+	PARKOUR_TRACE_ACTION(CharacterOwner, EParkourAction::LedgeHang, false);
+
+	PARKOUR_LOG(LogParkourLedge, Log, TEXT("End Ledge Hang %i"), PawnOwner->GetLocalRole());
 
 	SetMovementMode(EMovementMode::MOVE_Falling);
 
@@ -1601,6 +2616,8 @@ void UParkourMovementComponent::UpdateLedgeHangState()
 
 void UParkourMovementComponent::BeginClimbLedge()
 {
+	PARKOUR_TRACE_ACTION(CharacterOwner, EParkourAction::ClimbLedge, true);
+
 	IsClimbingLedge = true;
 	ClimbQueued = true;
 
@@ -1611,8 +2628,8 @@ void UParkourMovementComponent::BeginClimbLedge()
 	AdjustedLocation.Z += 60;
 	GetCharacterOwner()->SetActorLocation(AdjustedLocation);
 
-	UE_LOG(LogParkourMovement, Warning, TEXT("Begin Climb %i"), GetPawnOwner()->GetLocalRole());
-	UE_LOG(LogParkourMovement, Warning, TEXT("Climb Start Position: %s %i"), *CharacterOwner->GetActorLocation().ToString(), GetPawnOwner()->GetLocalRole());
+	PARKOUR_LOG(LogParkourLedge, Log, TEXT("Begin Climb %i"), GetPawnOwner()->GetLocalRole());
+	PARKOUR_LOG(LogParkourLedge, Log, TEXT("Climb Start Position: %s %i"), *CharacterOwner->GetActorLocation().ToString(), GetPawnOwner()->GetLocalRole());
 
 	SetMovementMode(EMovementMode::MOVE_Flying);
 
@@ -1630,6 +2647,8 @@ void UParkourMovementComponent::BeginClimbLedge()
 
 void UParkourMovementComponent::EndClimbLedge()
 {
+	PARKOUR_TRACE_ACTION(CharacterOwner, EParkourAction::ClimbLedge, false);
+
 	IsClimbingLedge = false;
 	EndClimbQueued = true;
 
@@ -1638,7 +2657,7 @@ void UParkourMovementComponent::EndClimbLedge()
 
 	SetCameraRotationLimit(-89.00002, 89.00002, -89.00002, 89.00002, 0, 359.98993);
 
-	UE_LOG(LogParkourMovement, Warning, TEXT("Climb End Position: %s %i"), *CharacterOwner->GetActorLocation().ToString(), GetPawnOwner()->GetLocalRole());
+	PARKOUR_LOG(LogParkourLedge, Log, TEXT("Climb End Position: %s %i"), *CharacterOwner->GetActorLocation().ToString(), GetPawnOwner()->GetLocalRole());
 }
 
 #pragma endregion
@@ -1668,7 +2687,7 @@ void UParkourMovementComponent::PhysCustom(float deltaTime, int32 Iterations)
 	{
 	case ECustomMovementMode::CMOVE_WallRunning:
 	{
-		UE_LOG(LogParkourMovement, Warning, TEXT("Phys Wall Run %i"), GetPawnOwner()->GetLocalRole());
+		PARKOUR_LOG(LogParkourWallRun, VeryVerbose, TEXT("Phys Wall Run %i"), GetPawnOwner()->GetLocalRole());
 
 		PhysWallRun(deltaTime, Iterations);
 
@@ -1676,7 +2695,7 @@ void UParkourMovementComponent::PhysCustom(float deltaTime, int32 Iterations)
 	}
 	case ECustomMovementMode::CMOVE_VerticalWallRunning:
 	{
-		UE_LOG(LogParkourMovement, Warning, TEXT("Phys Vertical Wall Run %i"), GetPawnOwner()->GetLocalRole());
+		PARKOUR_LOG(LogParkourWallRun, VeryVerbose, TEXT("Phys Vertical Wall Run %i"), GetPawnOwner()->GetLocalRole());
 
 		PhysVerticalWallRun(deltaTime, Iterations);
 
@@ -1684,7 +2703,7 @@ void UParkourMovementComponent::PhysCustom(float deltaTime, int32 Iterations)
 	}
 	case ECustomMovementMode::CMOVE_Sliding:
 	{
-		UE_LOG(LogParkourMovement, Warning, TEXT("Phys Sliding %i"), GetPawnOwner()->GetLocalRole());
+		PARKOUR_LOG(LogParkourSlide, VeryVerbose, TEXT("Phys Sliding %i"), GetPawnOwner()->GetLocalRole());
 
 		PhysSlide(deltaTime, Iterations);
 
@@ -1692,7 +2711,7 @@ void UParkourMovementComponent::PhysCustom(float deltaTime, int32 Iterations)
 	}
 	case ECustomMovementMode::CMOVE_Ziplining:
 	{
-		UE_LOG(LogParkourMovement, Warning, TEXT("Phys Zipline %i"), GetPawnOwner()->GetLocalRole());
+		PARKOUR_LOG(LogParkourZipline, VeryVerbose, TEXT("Phys Zipline %i"), GetPawnOwner()->GetLocalRole());
 
 		PhysZipline(deltaTime, Iterations);
 
@@ -1700,7 +2719,7 @@ void UParkourMovementComponent::PhysCustom(float deltaTime, int32 Iterations)
 	}
 	case ECustomMovementMode::CMOVE_ClimbLadder:
 	{
-		UE_LOG(LogParkourMovement, Warning, TEXT("Phys Climb Ladder %i"), GetPawnOwner()->GetLocalRole());
+		PARKOUR_LOG(LogParkourLadder, VeryVerbose, TEXT("Phys Climb Ladder %i"), GetPawnOwner()->GetLocalRole());
 
 		PhysClimbLadder(deltaTime, Iterations);
 
@@ -1708,7 +2727,7 @@ void UParkourMovementComponent::PhysCustom(float deltaTime, int32 Iterations)
 	}
 	case ECustomMovementMode::CMOVE_LedgeHang:
 	{
-		UE_LOG(LogParkourMovement, Warning, TEXT("Phys Ledge Hang %i"), GetPawnOwner()->GetLocalRole());
+		PARKOUR_LOG(LogParkourLedge, VeryVerbose, TEXT("Phys Ledge Hang %i"), GetPawnOwner()->GetLocalRole());
 
 		PhysLedgeHang(deltaTime, Iterations);
 
@@ -1721,16 +2740,22 @@ void UParkourMovementComponent::PhysCustom(float deltaTime, int32 Iterations)
 
 void UParkourMovementComponent::PhysWallRun(float deltaTime, int32 Iterations)
 {
+	PARKOUR_SCOPE_CYCLE_COUNTER(STAT_ParkourPhysWallRun);
+	CSV_SCOPED_TIMING_STAT(ParkourMovement, PhysWallRun);
+
 	// End the wall run if the player is no longer holding down the wall running key
 	if (WantsToWallRun == false)
 	{
-		UE_LOG(LogTemp, Warning, TEXT("RETURN PHYS %i"), GetPawnOwner()->GetLocalRole());
+		PARKOUR_LOG(LogParkourWallRun, Log, TEXT("RETURN PHYS %i"), GetPawnOwner()->GetLocalRole());
 		EndWallRun();
 		return;
 	}
 
+	// While the character stays along the cached wall plane the wall traces below can be skipped
+	const bool OnWallPlane = IsNextToWallPlane();
+
 	// End the wall run if the player is no long on a wall
-	if (IsNextToWall(WallRunLineTraceVerticalTolerance) == false)
+	if (OnWallPlane == false && IsNextToWall(WallRunLineTraceVerticalTolerance) == false)
 	{
 		EndWallRun();
 		return;
@@ -1743,47 +2768,55 @@ void UParkourMovementComponent::PhysWallRun(float deltaTime, int32 Iterations)
 		return;
 	}
 
-	// required parameters for line traces
-	FVector TraceStart = CharacterOwner->GetActorLocation();
-	FVector TraceEnd = GetWallRunEndVectorL();
-	FHitResult HitL;
-	FHitResult HitR;
-	FCollisionQueryParams TraceParams;
-	TraceParams.AddIgnoredActor(CharacterOwner);
-
-	GetWorld()->LineTraceSingleByChannel(HitL, TraceStart, TraceEnd, ECC_Visibility, TraceParams);
-
-	if (DrawDebug)
-	{
-		DrawDebugLine(GetWorld(), TraceStart, TraceEnd, FColor::Emerald, true, 1, 0, 2);
-	}
-
-	// Set the wall run direction based whether a wall is found on the left or the right side of the character
-	if (HitL.bBlockingHit)
-	{
-		if (IsValidWallRunVector(HitL.Normal, true))
-		{
-			WallRunDirection = 1.0;
-		}
-	}
-	else
+	if (OnWallPlane == false)
 	{
-		TraceEnd = GetWallRunEndVectorR();
+		// required parameters for line traces
+		FVector TraceStart = CharacterOwner->GetActorLocation();
+		FVector TraceEnd = GetWallRunEndVectorL();
+		FHitResult HitL;
+		FHitResult HitR;
+		FCollisionQueryParams TraceParams;
+		TraceParams.AddIgnoredActor(CharacterOwner);
 
-		GetWorld()->LineTraceSingleByChannel(HitL, TraceStart, TraceEnd, ECC_Visibility, TraceParams);
+		ParkourLineTrace(HitL, TraceStart, TraceEnd, TraceParams);
 
 		if (DrawDebug)
 		{
-			DrawDebugLine(GetWorld(), TraceStart, TraceEnd, FColor::Blue, true, 1, 0, 2);
+			DrawDebugLine(GetWorld(), TraceStart, TraceEnd, FColor::Emerald, true, 1, 0, 2);
 		}
 
+		// Set the wall run direction based whether a wall is found on the left or the right side of the character
 		if (HitL.bBlockingHit)
 		{
 			if (IsValidWallRunVector(HitL.Normal, true))
 			{
-				WallRunDirection = -1.0;
+				WallRunDirection = 1.0;
+			}
+		}
+		else
+		{
+			TraceEnd = GetWallRunEndVectorR();
+
+			ParkourLineTrace(HitL, TraceStart, TraceEnd, TraceParams);
+
+			if (DrawDebug)
+			{
+				DrawDebugLine(GetWorld(), TraceStart, TraceEnd, FColor::Blue, true, 1, 0, 2);
+			}
+
+			if (HitL.bBlockingHit)
+			{
+				if (IsValidWallRunVector(HitL.Normal, true))
+				{
+					WallRunDirection = -1.0;
+				}
 			}
 		}
+
+		if (HitL.bBlockingHit && IsValidWallRunVector(HitL.Normal, false))
+		{
+			CacheWallPlane(HitL);
+		}
 	}
 
 	// Add forward force
@@ -1807,11 +2840,14 @@ void UParkourMovementComponent::PhysWallRun(float deltaTime, int32 Iterations)
 
 void UParkourMovementComponent::PhysVerticalWallRun(float deltaTime, int32 Iterations)
 {
+	PARKOUR_SCOPE_CYCLE_COUNTER(STAT_ParkourPhysVerticalWallRun);
+	CSV_SCOPED_TIMING_STAT(ParkourMovement, PhysVerticalWallRun);
+
 	if (WantsToVerticalWallRun == false)
 	{
 		EndVerticalWallRun();
 
-		UE_LOG(LogParkourMovement, Warning, TEXT("Vertical wall run ended by wants to vertical wall run false"));
+		PARKOUR_LOG(LogParkourWallRun, Log, TEXT("Vertical wall run ended by wants to vertical wall run false"));
 	}
 
 	float CurrentSpeed = Velocity.Size();
@@ -1820,14 +2856,14 @@ void UParkourMovementComponent::PhysVerticalWallRun(float deltaTime, int32 Itera
 	{
 		EndVerticalWallRun();
 
-		UE_LOG(LogParkourMovement, Warning, TEXT("Vertical wall run ended by min speed"));
+		PARKOUR_LOG(LogParkourWallRun, Log, TEXT("Vertical wall run ended by min speed"));
 	}
 
 	if (!IsFacingTowardsWall && !IsRotatingAwayFromWall && CurrentSpeed > VerticalWallRunMaxSpeedFacingAwayFromWall)
 	{
 		EndVerticalWallRun();
 
-		UE_LOG(LogParkourMovement, Warning, TEXT("Vertical wall run ended by max speed"));
+		PARKOUR_LOG(LogParkourWallRun, Log, TEXT("Vertical wall run ended by max speed"));
 	}
 
 	SetVerticalWallRunVelocity(CurrentSpeed);
@@ -1864,7 +2900,7 @@ void UParkourMovementComponent::SetVerticalWallRunVelocity(float Speed)
 	
 
 
-	GetWorld()->LineTraceSingleByChannel(HitWall, TraceStart, TraceEnd, ECC_Visibility, TraceParams);
+	ParkourLineTrace(HitWall, TraceStart, TraceEnd, TraceParams);
 
 	FVector WallNormal = HitWall.ImpactNormal;
 
@@ -1895,8 +2931,8 @@ void UParkourMovementComponent::SetVerticalWallRunVelocity(float Speed)
 	}
 	
 
-	UE_LOG(LogParkourMovement, Warning, TEXT("Vertical Wall Run Velocity: %s"), *Velocity.ToString());
-	UE_LOG(LogParkourMovement, Warning, TEXT("Vertical Wall Run Gravity To Add: %s"), *GravityToAdd.ToString());
+	PARKOUR_LOG(LogParkourWallRun, VeryVerbose, TEXT("Vertical Wall Run Velocity: %s"), *Velocity.ToString());
+	PARKOUR_LOG(LogParkourWallRun, VeryVerbose, TEXT("Vertical Wall Run Gravity To Add: %s"), *GravityToAdd.ToString());
 }
 
 void UParkourMovementComponent::SetVerticalWallRunRotation()
@@ -1907,22 +2943,22 @@ void UParkourMovementComponent::SetVerticalWallRunRotation()
 	}
 
 	if (WantsToVerticalWallRunRotate)
-		UE_LOG(LogParkourMovement, Warning, TEXT("WANTS TO VERTICAL WALL RUN ROTATE %i"), GetPawnOwner()->GetLocalRole());
+		PARKOUR_LOG(LogParkourWallRun, VeryVerbose, TEXT("WANTS TO VERTICAL WALL RUN ROTATE %i"), GetPawnOwner()->GetLocalRole());
 
 	if (WantsToVerticalWallRunRotate && IsFacingTowardsWall && !IsRotatingAwayFromWall)
 	{
 		IsFacingTowardsWall = false;
 		IsRotatingAwayFromWall = true;
 
-		UE_LOG(LogParkourMovement, Warning, TEXT("Set Vertical Wall Run Rotation %i"), GetPawnOwner()->GetLocalRole());
+		PARKOUR_LOG(LogParkourWallRun, Log, TEXT("Set Vertical Wall Run Rotation %i"), GetPawnOwner()->GetLocalRole());
 
 		VerticalWallRunTargetRotation = CharacterOwner->GetActorRotation();
 
-		UE_LOG(LogParkourMovement, Warning, TEXT("Vertical Wall Run Starting Rotation: %s"), *VerticalWallRunTargetRotation.ToString());
+		PARKOUR_LOG(LogParkourWallRun, Log, TEXT("Vertical Wall Run Starting Rotation: %s"), *VerticalWallRunTargetRotation.ToString());
 
 		VerticalWallRunTargetRotation.Yaw = VerticalWallRunTargetRotation.Yaw + 180;
 
-		UE_LOG(LogParkourMovement, Warning, TEXT("Vertical Wall Run Target Rotation: %s"), *VerticalWallRunTargetRotation.ToString());
+		PARKOUR_LOG(LogParkourWallRun, Log, TEXT("Vertical Wall Run Target Rotation: %s"), *VerticalWallRunTargetRotation.ToString());
 
 		GetParkourFPSCharacter()->bAcceptingMovementInput = true;
 		GetParkourFPSCharacter()->bUseControllerRotationYaw = true;
@@ -1947,13 +2983,13 @@ void UParkourMovementComponent::ApplyVerticalWallRunRotation()
 		FVector CurrentRotationVector = CharacterOwner->GetActorRotation().Vector();
 		FVector TargetRotationVector = VerticalWallRunTargetRotation.Vector();
 
-		UE_LOG(LogParkourMovement, Warning, TEXT("Controller Rotation: %s"), *GetPawnOwner()->GetControlRotation().ToString());
-		UE_LOG(LogParkourMovement, Warning, TEXT("Yaw Difference: %f"), YawDifference);
+		PARKOUR_LOG(LogParkourWallRun, VeryVerbose, TEXT("Controller Rotation: %s"), *GetPawnOwner()->GetControlRotation().ToString());
+		PARKOUR_LOG(LogParkourWallRun, VeryVerbose, TEXT("Yaw Difference: %f"), YawDifference);
 
 		if (FVector::Coincident(CurrentRotationVector, TargetRotationVector, cosf(VerticalWallRunRotationCoincidentCosine)))
 		{
 			IsRotatingAwayFromWall = false;
-			UE_LOG(LogParkourMovement, Warning, TEXT("ENDING VERTICAL WALL RUN ROTATION"));
+			PARKOUR_LOG(LogParkourWallRun, Log, TEXT("ENDING VERTICAL WALL RUN ROTATION"));
 
 			GetParkourFPSCharacter()->bAcceptingMovementInput = false;
 			GetParkourFPSCharacter()->bUseControllerRotationYaw = false;
@@ -1975,61 +3011,161 @@ void UParkourMovementComponent::ApplyVerticalWallRunRotation()
 
 void UParkourMovementComponent::PhysSlide(float deltaTime, int32 Iterations)
 {
-	float CurrentSpeed = Velocity.Size();
+	PARKOUR_SCOPE_CYCLE_COUNTER(STAT_ParkourPhysSlide);
+	CSV_SCOPED_TIMING_STAT(ParkourMovement, PhysSlide);
 
-	// 
-	if (CurrentSpeed < CrouchSpeed || !WantsToSlide)
+	if (deltaTime < MIN_TICK_TIME)
+	{
+		return;
+	}
+
+	// Too slow to keep sliding or the slide key was let go, the rest of the move is walked
+	if (Velocity.Size() < CrouchSpeed || !WantsToSlide)
 	{
 		EndSlide();
+		StartNewPhysics(deltaTime, Iterations);
 
 		return;
 	}
 
+	// A ground move like PhysWalking, without input acceleration and with the floor influence pulling the slide down slopes
+	bJustTeleported = false;
+	float RemainingTime = deltaTime;
 
-	FHitResult FloorHitResult;
-	FVector TraceStart = CharacterOwner->GetActorLocation();
-	FVector TraceEnd = TraceStart;
-	TraceEnd.Z -= 200;
+	while (RemainingTime >= MIN_TICK_TIME && Iterations < MaxSimulationIterations)
+	{
+		Iterations++;
+		bJustTeleported = false;
+		const float TimeTick = GetSimulationTimeStep(RemainingTime, Iterations);
+		RemainingTime -= TimeTick;
 
-	FCollisionQueryParams TraceParams;
-	TraceParams.AddIgnoredActor(CharacterOwner);
-	TraceParams.AddIgnoredActor(GetPawnOwner());
+		const FVector OldLocation = UpdatedComponent->GetComponentLocation();
 
-	GetWorld()->LineTraceSingleByChannel(FloorHitResult, TraceStart, TraceEnd, ECC_Visibility, TraceParams);
+		// Usually the floor the last move ended on. A fresh sample only reaches just under the capsule, look as far down as a step
+		// before falling.
+		if (GetCustomModeFloor().IsWalkableFloor() == false)
+		{
+			FindFloor(OldLocation, CurrentFloor, false);
 
-	if (!FloorHitResult.bBlockingHit)
-	{
-		EndSlide();
-	}
+			if (CurrentFloor.IsWalkableFloor() == false)
+			{
+				PARKOUR_LOG(LogParkourSlide, Verbose, TEXT("Slide Floor Not Found"));
 
+				SetMovementMode(EMovementMode::MOVE_Falling);
+				StartNewPhysics(RemainingTime + TimeTick, Iterations - 1);
 
-	FVector FloorInfluenceForce = CalculateFloorInfluence(FloorHitResult.ImpactNormal);
+				return;
+			}
 
-	Velocity += FloorInfluenceForce;
+			AdjustFloorHeight();
+			CustomModeFloorValid = true;
+		}
 
-	UE_LOG(LogParkourMovement, Warning, TEXT("FLOOR INFLUENCE: %s"), *FloorInfluenceForce.ToString());
-	UE_LOG(LogParkourMovement, Warning, TEXT("Velocity: %s"), *Velocity.ToString());
+		const FFindFloorResult OldFloor = CurrentFloor;
+		const FVector FloorNormal = CurrentFloor.HitResult.ImpactNormal;
 
-	if (FloorInfluenceForce.Z == 0.0)
-	{
-		Velocity.Z = 0.0;
-	}
+		MaintainHorizontalGroundVelocity();
+		Acceleration.Z = 0.f;
 
+		// The floor influence is the only slope force. It accelerates the slide the same as the AddForce slides got while they ran
+		// in walking mode, and BeginSlide's braking and friction apply the way PhysWalking applies them.
+		const FVector FloorInfluenceForce = CalculateFloorInfluence(FloorNormal);
 
-	CurrentSpeed = Velocity.Size();
+		if (Mass > SMALL_NUMBER)
+		{
+			Velocity += FloorInfluenceForce / Mass * TimeTick;
+		}
 
-	if (CurrentSpeed > SlideTerminalSpeed)
-	{
-		Velocity.Normalize();
-		Velocity *= SlideTerminalSpeed;
-	}
+		CalcVelocity(TimeTick, GroundFriction, false, BrakingDecelerationWalking);
 
+		if (Velocity.Size() > SlideTerminalSpeed)
+		{
+			Velocity = Velocity.GetSafeNormal() * SlideTerminalSpeed;
+		}
 
-	CalcVelocity(deltaTime, 0.0, true, 1000.0);
+		PARKOUR_LOG(LogParkourSlide, VeryVerbose, TEXT("FLOOR INFLUENCE: %s"), *FloorInfluenceForce.ToString());
+		PARKOUR_LOG(LogParkourSlide, VeryVerbose, TEXT("Velocity: %s"), *Velocity.ToString());
 
-	const FVector AdjustedVelocity = Velocity * deltaTime;
-	FHitResult Hit(1.f);
-	SafeMoveUpdatedComponent(AdjustedVelocity, UpdatedComponent->GetComponentQuat(), true, Hit);
+		const FVector MoveVelocity = Velocity;
+		const FVector Delta = MoveVelocity * TimeTick;
+		const bool ZeroDelta = Delta.IsNearlyZero();
+		FStepDownResult StepDownResult;
+
+		if (ZeroDelta)
+		{
+			RemainingTime = 0.f;
+		}
+		else
+		{
+			// Follows ramps, slides along walls and steps up the way walking does
+			MoveAlongFloor(MoveVelocity, TimeTick, &StepDownResult);
+
+			// A hit during the move can start another parkour move through OnActorHit, it takes the rest of the time
+			if (IsCustomMovementMode(ECustomMovementMode::CMOVE_Sliding) == false)
+			{
+				const float DesiredDist = Delta.Size();
+				const float ActualDist = (UpdatedComponent->GetComponentLocation() - OldLocation).Size2D();
+
+				RemainingTime += TimeTick * (1.f - FMath::Min(1.f, ActualDist / DesiredDist));
+				StartNewPhysics(RemainingTime, Iterations);
+
+				return;
+			}
+		}
+
+		if (StepDownResult.bComputedFloor)
+		{
+			CurrentFloor = StepDownResult.FloorResult;
+		}
+		else
+		{
+			FindFloor(UpdatedComponent->GetComponentLocation(), CurrentFloor, ZeroDelta, nullptr);
+		}
+
+		if (CurrentFloor.IsWalkableFloor())
+		{
+			AdjustFloorHeight();
+			SetBase(CurrentFloor.HitResult.Component.Get(), CurrentFloor.HitResult.BoneName);
+
+			// CurrentFloor is under the capsule again, the next iteration and the next move start from it without another query
+			CustomModeFloorValid = true;
+		}
+		else if (CurrentFloor.HitResult.bStartPenetrating == false)
+		{
+			// Slid off an edge or onto a floor too steep to stand on. Falling ends the slide through OnMovementModeChanged.
+			HandleWalkingOffLedge(OldFloor.HitResult.ImpactNormal, OldFloor.HitResult.Normal, OldLocation, TimeTick);
+
+			if (IsCustomMovementMode(ECustomMovementMode::CMOVE_Sliding))
+			{
+				StartFalling(Iterations, RemainingTime, TimeTick, Delta, OldLocation);
+			}
+
+			return;
+		}
+		else if (RemainingTime <= 0.f)
+		{
+			// The floor sweep started inside geometry, push out of it the way PhysWalking does
+			FHitResult Hit(CurrentFloor.HitResult);
+			Hit.TraceEnd = Hit.TraceStart + FVector(0.f, 0.f, MAX_FLOOR_DIST);
+			const FVector RequestedAdjustment = GetPenetrationAdjustment(Hit);
+			ResolvePenetration(RequestedAdjustment, Hit, UpdatedComponent->GetComponentQuat());
+			bForceNextFloorCheck = true;
+		}
+
+		// Keep the velocity the capsule actually moved with, so running into a wall slows the slide down
+		if (bJustTeleported == false && TimeTick >= MIN_TICK_TIME)
+		{
+			Velocity = (UpdatedComponent->GetComponentLocation() - OldLocation) / TimeTick;
+			MaintainHorizontalGroundVelocity();
+		}
+
+		if (UpdatedComponent->GetComponentLocation() == OldLocation)
+		{
+			break;
+		}
+	}
+
+	MaintainHorizontalGroundVelocity();
 }
 
 void UParkourMovementComponent::ApplySlideForce()
@@ -2043,44 +3179,28 @@ void UParkourMovementComponent::ApplySlideForce()
 
 	if (CurrentSpeed < CrouchSpeed)
 	{
-		UE_LOG(LogParkourMovement, Warning, TEXT("SLIDE SPEED TO SLOW"));
+		PARKOUR_LOG(LogParkourSlide, Verbose, TEXT("SLIDE SPEED TO SLOW"));
 	}
 
 	if (CurrentSpeed < CrouchSpeed || !WantsToSlide)
 	{
 		EndSlide();
 
-		return;
-	}
-
-	if (CurrentSpeed > SlideTerminalSpeed)
-	{
-		Velocity.Normalize();
-		Velocity *= SlideTerminalSpeed;
-	}
-
-
-
-	FHitResult FloorHitResult;
-	FVector TraceStart = CharacterOwner->GetActorLocation();
-	FVector TraceEnd = TraceStart;
-	TraceEnd.Z -= 200;
-
-	FCollisionQueryParams TraceParams;
-	TraceParams.AddIgnoredActor(CharacterOwner);
-	TraceParams.AddIgnoredActor(GetPawnOwner());
-
-	GetWorld()->LineTraceSingleByChannel(FloorHitResult, TraceStart, TraceEnd, ECC_Visibility, TraceParams);
-
-	FVector FloorInfluenceForce = CalculateFloorInfluence(FloorHitResult.ImpactNormal);
-
-	UE_LOG(LogParkourMovement, Warning, TEXT("FLOOR INFLUENCE FORCE: %s"), *FloorInfluenceForce.ToString());
+		return;
+	}
 
-	AddForce(FloorInfluenceForce);
+	if (CurrentSpeed > SlideTerminalSpeed)
+	{
+		Velocity.Normalize();
+		Velocity *= SlideTerminalSpeed;
+	}
 }
 
 void UParkourMovementComponent::PhysZipline(float DeltaTime, int32 Iterations)
 {
+	PARKOUR_SCOPE_CYCLE_COUNTER(STAT_ParkourPhysZipline);
+	CSV_SCOPED_TIMING_STAT(ParkourMovement, PhysZipline);
+
 	if (WantsToZiplineLadder == false)
 	{
 		EndZipline();
@@ -2105,16 +3225,22 @@ void UParkourMovementComponent::PhysZipline(float DeltaTime, int32 Iterations)
 		return;
 	}
 
-	Velocity += (ZiplineDirection * ZiplineAcceleration);
+	Velocity += ZiplineDirection * ZiplineAccelerationPerSecond * DeltaTime;
 
-	UE_LOG(LogParkourMovement, Warning, TEXT("Zipline velocity: %s"), *Velocity.ToString());
+	PARKOUR_LOG(LogParkourZipline, VeryVerbose, TEXT("Zipline velocity: %s"), *Velocity.ToString());
 	
 	float Speed = Velocity.Size();
 
 	if (Speed > ZiplineMaxSpeed)
 	{
 		Velocity.Normalize();
-		Velocity = Velocity * Speed;
+		Velocity = Velocity * ZiplineMaxSpeed;
+	}
+
+	if (CharacterOwner->HasAuthority() && IsRailAnchorStale(CurrentZipline.Get()))
+	{
+		// The proxies extrapolate with the same per second acceleration PhysZipline integrates, independent of the server's move lengths
+		UpdateRailAnchor(CurrentZipline.Get(), FVector::DotProduct(Velocity, ZiplineDirection), ZiplineAccelerationPerSecond, ZiplineMaxSpeed);
 	}
 
 	const FVector AdjustedVelocity = Velocity * DeltaTime;
@@ -2124,9 +3250,12 @@ void UParkourMovementComponent::PhysZipline(float DeltaTime, int32 Iterations)
 
 void UParkourMovementComponent::PhysClimbLadder(float DeltaTime, int32 Iterations)
 {
+	PARKOUR_SCOPE_CYCLE_COUNTER(STAT_ParkourPhysClimbLadder);
+	CSV_SCOPED_TIMING_STAT(ParkourMovement, PhysClimbLadder);
+
 	if (!WantsToZiplineLadder)
 	{
-		UE_LOG(LogParkourMovement, Warning, TEXT("Climb Ladder Ended By WantsToZiplineLadder false"));
+		PARKOUR_LOG(LogParkourLadder, Log, TEXT("Climb Ladder Ended By WantsToZiplineLadder false"));
 
 		EndClimbLadder();
 		return;
@@ -2134,7 +3263,7 @@ void UParkourMovementComponent::PhysClimbLadder(float DeltaTime, int32 Iteration
 
 	if (CheckWallRunFloor(1.4) == false && WantsToClimbLadderDown)
 	{
-		UE_LOG(LogParkourMovement, Warning, TEXT("Climb Ladder Ended By Floor"));
+		PARKOUR_LOG(LogParkourLadder, Log, TEXT("Climb Ladder Ended By Floor"));
 
 		EndClimbLadder();
 		return;
@@ -2144,11 +3273,11 @@ void UParkourMovementComponent::PhysClimbLadder(float DeltaTime, int32 Iteration
 	float CharacterFeetHeight = CharacterOwner->GetActorLocation().Z;
 	CharacterFeetHeight -= CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleHalfHeight();
 
-	UE_LOG(LogParkourMovement, Warning, TEXT("Ladder Climb - Character Feet Height: %f, Ladder Top = %f"), CharacterFeetHeight, LadderTop.Z);
+	PARKOUR_LOG(LogParkourLadder, VeryVerbose, TEXT("Ladder Climb - Character Feet Height: %f, Ladder Top = %f"), CharacterFeetHeight, LadderTop.Z);
 
 	if (CharacterFeetHeight >= LadderTop.Z)
 	{
-		UE_LOG(LogParkourMovement, Warning, TEXT("Climb Ladder Ended By Passing Top"));
+		PARKOUR_LOG(LogParkourLadder, Log, TEXT("Climb Ladder Ended By Passing Top"));
 
 		EndClimbLadder();
 		return;
@@ -2158,11 +3287,11 @@ void UParkourMovementComponent::PhysClimbLadder(float DeltaTime, int32 Iteration
 	float CharacterHeadHeight = CharacterOwner->GetActorLocation().Z;
 	CharacterHeadHeight += CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleHalfHeight();
 
-	UE_LOG(LogParkourMovement, Warning, TEXT("Ladder Climb - Character Head Height: %f, Ladder Bottom = %f"), CharacterHeadHeight, LadderBottom.Z);
+	PARKOUR_LOG(LogParkourLadder, VeryVerbose, TEXT("Ladder Climb - Character Head Height: %f, Ladder Bottom = %f"), CharacterHeadHeight, LadderBottom.Z);
 
 	if (CharacterHeadHeight <= LadderBottom.Z)
 	{
-		UE_LOG(LogParkourMovement, Warning, TEXT("Climb Ladder Ended By Passing Bottom"));
+		PARKOUR_LOG(LogParkourLadder, Log, TEXT("Climb Ladder Ended By Passing Bottom"));
 
 		EndClimbLadder();
 		return;
@@ -2198,6 +3327,11 @@ void UParkourMovementComponent::PhysClimbLadder(float DeltaTime, int32 Iteration
 		}
 	}
 
+	if (CharacterOwner->HasAuthority() && (Velocity != OldVelocity || IsRailAnchorStale(CurrentLadder.Get())))
+	{
+		UpdateRailAnchor(CurrentLadder.Get(), Velocity.Z, 0.f, 0.f);
+	}
+
 	const FVector AdjustedVelocity = Velocity * DeltaTime;
 	FHitResult Hit(1.f);
 	SafeMoveUpdatedComponent(AdjustedVelocity, UpdatedComponent->GetComponentQuat(), true, Hit);
@@ -2205,6 +3339,9 @@ void UParkourMovementComponent::PhysClimbLadder(float DeltaTime, int32 Iteration
 
 void UParkourMovementComponent::PhysLedgeHang(float DeltaTime, int32 Iterations)
 {
+	PARKOUR_SCOPE_CYCLE_COUNTER(STAT_ParkourPhysLedgeHang);
+	CSV_SCOPED_TIMING_STAT(ParkourMovement, PhysLedgeHang);
+
 	if (CharacterOwner->GetActorLocation().Z <= (LedgeHeight - LedgeHeightOffset))
 	{
 		Velocity = FVector(0, 0, 0);
@@ -2244,16 +3381,6 @@ void UParkourMovementComponent::SetWantsToCustomJump(bool keyIsDown)
 	}
 }
 
-bool UParkourMovementComponent::ServerSetWantsToCustomJump_Validate(const bool WantsToJump)
-{
-	return true;
-}
-
-void UParkourMovementComponent::ServerSetWantsToCustomJump_Implementation(const bool WantsToJump)
-{
-	WantsToCustomJump = WantsToJump;
-}
-
 void UParkourMovementComponent::SetWantsToVerticalWallRunRotate(bool KeyIsDown)
 {
 	if (IsCustomMovementMode(ECustomMovementMode::CMOVE_VerticalWallRunning))
@@ -2266,16 +3393,6 @@ void UParkourMovementComponent::SetWantsToVerticalWallRunRotate(bool KeyIsDown)
 	}
 }
 
-bool UParkourMovementComponent::ServerSetWantsToVerticalWallRunRotate_Validate(const bool WantsToRotate)
-{
-	return true;
-}
-
-void UParkourMovementComponent::ServerSetWantsToVerticalWallRunRotate_Implementation(const bool WantsToRotate)
-{
-	WantsToVerticalWallRunRotate = WantsToRotate;
-}
-
 void UParkourMovementComponent::SetWantsToStopZipline(bool KeyIsDown)
 {
 	if (IsZiplining && KeyIsDown)
@@ -2294,26 +3411,6 @@ void UParkourMovementComponent::SetWantsToGoDownLadder(bool KeyIsDown)
 	WantsToClimbLadderDown = KeyIsDown;
 }
 
-bool UParkourMovementComponent::ServerSetWantsToGoUpLadder_Validate(const bool WantsToGoUp)
-{
-	return true;
-}
-
-void UParkourMovementComponent::ServerSetWantsToGoUpLadder_Implementation(const bool WantsToGoUp)
-{
-	WantsToClimbLadderUp = WantsToGoUp;
-}
-
-bool UParkourMovementComponent::ServerSetWantsToGoDownLadder_Validate(const bool WantsToGoDown)
-{
-	return true;
-}
-
-void UParkourMovementComponent::ServerSetWantsToGoDownLadder_Implementation(const bool WantsToGoDown)
-{
-	WantsToClimbLadderDown = WantsToGoDown;
-}
-
 void UParkourMovementComponent::SetWantsToStopLedgeHang(bool KeyIsDown)
 {
 	if (IsLedgeHanging)
@@ -2326,92 +3423,193 @@ void UParkourMovementComponent::SetWantsToStopLedgeHang(bool KeyIsDown)
 	}
 }
 
-bool UParkourMovementComponent::ServerSetWantsToStopLedgeHang_Validate(const bool WantsToStop)
+void UParkourMovementComponent::SetWantsToClimbLedge(bool KeyIsDown)
 {
-	return true;
+	WantsToClimbLedge = KeyIsDown;
 }
 
-void UParkourMovementComponent::ServerSetWantsToStopLedgeHang_Implementation(const bool WantsToStop)
+bool UParkourMovementComponent::IsMovingOnGround() const
 {
-	WantsToStopLedgeHang = WantsToStop;
+	// Sliding is ground movement, so crouching and jumping keep working during it
+	return Super::IsMovingOnGround() || IsCustomMovementMode(ECustomMovementMode::CMOVE_Sliding);
 }
 
-void UParkourMovementComponent::SetWantsToClimbLedge(bool KeyIsDown)
+void UParkourMovementComponent::OnTeleported()
 {
-	WantsToClimbLedge = KeyIsDown;
+	// Teleports set the location directly, without a move that would throw the floor sample away
+	CustomModeFloorValid = false;
+
+	Super::OnTeleported();
 }
 
-bool UParkourMovementComponent::ServerSetWantsToClimbLedge_Validate(const bool WantsToClimb)
+bool UParkourMovementComponent::IsCustomMovementMode(uint8 custom_movement_mode) const
 {
-	return true;
+	return MovementMode == EMovementMode::MOVE_Custom && CustomMovementMode == custom_movement_mode;
 }
 
-void UParkourMovementComponent::ServerSetWantsToClimbLedge_Implementation(const bool WantsToClimb)
+uint16 UParkourMovementComponent::GetParkourInputFlags() const
 {
-	WantsToClimbLedge = WantsToClimb;
+	uint16 Flags = EParkourInputFlags::None;
+
+	if (WantsToWallRun)
+		Flags |= EParkourInputFlags::WallRun;
+	if (WantsToSlide)
+		Flags |= EParkourInputFlags::Slide;
+	if (WantsToVerticalWallRun)
+		Flags |= EParkourInputFlags::VerticalWallRun;
+	if (WantsToZiplineLadder)
+		Flags |= EParkourInputFlags::ZiplineLadder;
+	if (WantsToCustomJump)
+		Flags |= EParkourInputFlags::CustomJump;
+	if (WantsToVerticalWallRunRotate)
+		Flags |= EParkourInputFlags::VerticalWallRunRotate;
+	if (WantsToClimbLadderUp)
+		Flags |= EParkourInputFlags::ClimbLadderUp;
+	if (WantsToClimbLadderDown)
+		Flags |= EParkourInputFlags::ClimbLadderDown;
+	if (WantsToStopLedgeHang)
+		Flags |= EParkourInputFlags::StopLedgeHang;
+	if (WantsToClimbLedge)
+		Flags |= EParkourInputFlags::ClimbLedge;
+
+	return Flags;
 }
 
-bool UParkourMovementComponent::IsCustomMovementMode(uint8 custom_movement_mode) const
+void UParkourMovementComponent::ApplyNetworkMoveDataFlags(uint16 Flags)
 {
-	return MovementMode == EMovementMode::MOVE_Custom && CustomMovementMode == custom_movement_mode;
+	WantsToCustomJump = (Flags & EParkourInputFlags::CustomJump) != 0;
+	WantsToVerticalWallRunRotate = (Flags & EParkourInputFlags::VerticalWallRunRotate) != 0;
+	WantsToClimbLadderUp = (Flags & EParkourInputFlags::ClimbLadderUp) != 0;
+	WantsToClimbLadderDown = (Flags & EParkourInputFlags::ClimbLadderDown) != 0;
+	WantsToStopLedgeHang = (Flags & EParkourInputFlags::StopLedgeHang) != 0;
+	WantsToClimbLedge = (Flags & EParkourInputFlags::ClimbLedge) != 0;
 }
 
-// logging correction details from the client pov when a movement correction is made
+// recording correction details from the client pov when a movement correction is made.
+// ClientAdjustPosition ends up here as well, so this is the only place corrections are recorded.
 void UParkourMovementComponent::OnClientCorrectionReceived(class FNetworkPredictionData_Client_Character& ClientData, float TimeStamp, FVector NewLocation, FVector NewVelocity,
 	UPrimitiveComponent* NewBase, FName NewBaseBoneName, bool bHasBase, bool bBaseRelativePosition, uint8 ServerMovementMode)
 {
-	LogClientCorrection(false, TimeStamp, NewLocation, NewVelocity, ServerMovementMode);
+	RecordClientCorrection(TimeStamp, NewLocation, NewVelocity, ServerMovementMode);
+
+	// saved moves newer than the corrected one are replayed on top of the server state after the correction
+	int32 ReplayedMoves = 0;
+
+	for (const FSavedMovePtr& SavedMove : ClientData.SavedMoves)
+	{
+		if (SavedMove.IsValid() && SavedMove->TimeStamp > TimeStamp)
+			ReplayedMoves++;
+	}
+
+	CSV_CUSTOM_STAT(ParkourMovement, Corrections, 1, ECsvCustomStatOp::Accumulate);
+
+	FParkourCorrectionAnalytics::Get().RecordCorrection(MovementMode, CustomMovementMode, FVector::Dist(UpdatedComponent->GetComponentLocation(), NewLocation),
+		FVector::Dist(Velocity, NewVelocity), ReplayedMoves);
+
+	// The correction sets the location directly, without a move that would throw the floor sample away
+	CustomModeFloorValid = false;
+
 	Super::OnClientCorrectionReceived(ClientData, TimeStamp, NewLocation, NewVelocity, NewBase, NewBaseBoneName, bHasBase, bBaseRelativePosition, ServerMovementMode);
 }
 
-// logging correction details when from the server pov when a movement correction is made
-void UParkourMovementComponent::ClientAdjustPosition(float TimeStamp, FVector NewLoc, FVector NewVel, UPrimitiveComponent* NewBase, FName NewBaseBoneName, bool bHasBase,
-	bool bBaseRelativePosition, uint8 ServerMovementMode)
+void UParkourMovementComponent::RecordClientCorrection(float TimeStamp, FVector NewLocation, FVector NewVelocity, uint8 ServerMovementMode)
+{
+	FParkourCorrectionRecord Record;
+
+	Record.Timestamp = FPlatformTime::Seconds();
+	Record.MoveTimeStamp = TimeStamp;
+	Record.ClientLocation = CharacterOwner->GetActorLocation();
+	Record.ServerLocation = NewLocation;
+	Record.ClientVelocity = Velocity;
+	Record.ServerVelocity = NewVelocity;
+	Record.MovementMode = MovementMode;
+	Record.CustomMovementMode = CustomMovementMode;
+	Record.ServerMovementMode = ServerMovementMode;
+
+	CorrectionRecorder.RecordCorrection(Record);
+
+	PARKOUR_LOG(LogMovementCorrections, Verbose, TEXT("Correction %f: Mode %i/%i Server Mode %i Position Error %f"), TimeStamp, (uint8)MovementMode, CustomMovementMode,
+		ServerMovementMode, FVector::Dist(Record.ClientLocation, NewLocation));
+}
+
+bool UParkourMovementComponent::DumpCorrectionRecorder(const FString& Filename) const
 {
-	LogClientCorrection(true, TimeStamp, NewLoc, NewVel, ServerMovementMode);
-	Super::ClientAdjustPosition(TimeStamp, NewLoc, NewVel, NewBase, NewBaseBoneName, bHasBase, bBaseRelativePosition, ServerMovementMode);
+	return CorrectionRecorder.DumpToFile(Filename);
 }
 
-void UParkourMovementComponent::LogClientCorrection(bool isServer, float TimeStamp, FVector NewLocation, FVector NewVelocity, uint8 ServerMovementMode)
+static void DumpParkourCorrections(const TArray<FString>& Args, UWorld* World)
 {
-	if (isServer)
+	if (World == nullptr)
 	{
-		UE_LOG(LogMovementCorrections, Log, TEXT("============= SERVER SENDING MOVEMENT CORRECTION ============="));
+		return;
 	}
-	else
+
+	// Optional first argument overrides the output directory
+	const FString Directory = Args.Num() > 0 ? Args[0] : FPaths::ProfilingDir() / TEXT("ParkourCorrections");
+	const FString Timestamp = FDateTime::Now().ToString();
+
+	for (TActorIterator<AParkourFPSCharacter> It(World); It; ++It)
 	{
-		UE_LOG(LogMovementCorrections, Log, TEXT("============= CLIENT RECEIVED MOVEMENT CORRECTION ============="));
+		UParkourMovementComponent* ParkourMovement = It->GetParkourMovementComponent();
+
+		if (ParkourMovement == nullptr)
+		{
+			continue;
+		}
+
+		const FString Filename = Directory / FString::Printf(TEXT("%s_%s.pkcr"), *It->GetName(), *Timestamp);
+
+		if (ParkourMovement->DumpCorrectionRecorder(Filename))
+		{
+			UE_LOG(LogMovementCorrections, Display, TEXT("Wrote movement corrections to %s"), *Filename);
+		}
+		else
+		{
+			UE_LOG(LogMovementCorrections, Warning, TEXT("Failed to write movement corrections to %s"), *Filename);
+		}
 	}
-	UE_LOG(LogMovementCorrections, Log, TEXT("    "));
-	UE_LOG(LogMovementCorrections, Log, TEXT("Time Stamp: %f"), TimeStamp);
-	UE_LOG(LogMovementCorrections, Log, TEXT("    "));
-	UE_LOG(LogMovementCorrections, Log, TEXT("Current Position: %s"), *CharacterOwner->GetActorLocation().ToString());
-	UE_LOG(LogMovementCorrections, Log, TEXT("Corrected Position: %s"), *NewLocation.ToString());
-	UE_LOG(LogMovementCorrections, Log, TEXT("    "));
-	UE_LOG(LogMovementCorrections, Log, TEXT("Current Velocity: %s"), *CharacterOwner->GetVelocity().ToString());
-	UE_LOG(LogMovementCorrections, Log, TEXT("Corrected Velocity: %s"), *NewVelocity.ToString());
-	UE_LOG(LogMovementCorrections, Log, TEXT("    "));
+}
 
-	const FString MovementModeString = StaticEnum<EMovementMode>()->GetValueAsString(MovementMode);
-	UE_LOG(LogMovementCorrections, Log, TEXT("Current Movement Mode: %s"), *MovementModeString);
-	UE_LOG(LogMovementCorrections, Log, TEXT("Current Movement Mode: %i"), (uint8)MovementMode);
-	UE_LOG(LogMovementCorrections, Log, TEXT("    "));
+static FAutoConsoleCommandWithWorldAndArgs DumpParkourCorrectionsCommand(
+	TEXT("p.Parkour.DumpCorrections"),
+	TEXT("Writes the movement correction flight recorder of every parkour character to Saved/Profiling/ParkourCorrections. Optional argument: output directory."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&DumpParkourCorrections));
 
-	if (MovementMode == EMovementMode::MOVE_Custom)
+static void ReportParkourRpcs(const TArray<FString>& Args, UWorld* World)
+{
+	if (World == nullptr)
 	{
-		const FString CustomMovementModeString = StaticEnum<ECustomMovementMode>()->GetValueAsString(static_cast<ECustomMovementMode>(CustomMovementMode));
-
-		UE_LOG(LogMovementCorrections, Log, TEXT("Custom Movement Mode: %s"), *CustomMovementModeString);
-		UE_LOG(LogMovementCorrections, Log, TEXT("Custom Movement Mode: %i"), CustomMovementMode);
-		UE_LOG(LogMovementCorrections, Log, TEXT("    "));
+		return;
 	}
 
-	UE_LOG(LogMovementCorrections, Log, TEXT("Server Movement Mode: %i"), ServerMovementMode);
+	for (TActorIterator<AParkourFPSCharacter> It(World); It; ++It)
+	{
+		const UParkourMovementComponent* ParkourMovement = It->GetParkourMovementComponent();
+
+		if (ParkourMovement == nullptr || It->GetLocalRole() != ROLE_AutonomousProxy)
+		{
+			continue;
+		}
+
+		const FParkourRpcAccounting& RpcAccounting = ParkourMovement->GetRpcAccounting();
+
+		UE_LOG(LogParkourMovement, Display, TEXT("%s: %.1f bytes/s total"), *It->GetName(), RpcAccounting.GetTotalBytesPerSecond());
+
+		for (int32 i = 0; i < EParkourRpc::Count; i++)
+		{
+			const EParkourRpc::Type Rpc = (EParkourRpc::Type)i;
 
-	UE_LOG(LogMovementCorrections, Log, TEXT("    "));
-	UE_LOG(LogMovementCorrections, Log, TEXT("    "));
+			UE_LOG(LogParkourMovement, Display, TEXT("    %-24s %6.1f calls/s %8.1f bytes/s"), EParkourRpc::ToString(Rpc), RpcAccounting.GetCallsPerSecond(Rpc),
+				RpcAccounting.GetBytesPerSecond(Rpc));
+		}
+	}
 }
 
+static FAutoConsoleCommandWithWorldAndArgs ReportParkourRpcsCommand(
+	TEXT("p.Parkour.RpcReport"),
+	TEXT("Logs server RPC calls and bytes per second for every locally controlled parkour character."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&ReportParkourRpcs));
+
 void FSavedMove_My::Clear()
 {
 	Super::Clear();
@@ -2458,9 +3656,29 @@ uint8 FSavedMove_My::GetCompressedFlags() const
 
 bool FSavedMove_My::CanCombineWith(const FSavedMovePtr& NewMovePtr, ACharacter* Character, float MaxDelta) const
 {
+	const FSavedMove_My* NewMove = static_cast<const FSavedMove_My*>(NewMovePtr.Get());
+
+	// The server replays a combined move with a single set of inputs, so never combine across a change in any parkour intent
+	if (GetParkourInputFlags() != NewMove->GetParkourInputFlags())
+	{
+		return false;
+	}
+
 	return Super::CanCombineWith(NewMovePtr, Character, MaxDelta);
 }
 
+bool FSavedMove_My::IsImportantMove(const FSavedMovePtr& LastAckedMove) const
+{
+	const FSavedMove_My* LastAckedParkourMove = static_cast<const FSavedMove_My*>(LastAckedMove.Get());
+
+	if (GetParkourInputFlags() != LastAckedParkourMove->GetParkourInputFlags())
+	{
+		return true;
+	}
+
+	return Super::IsImportantMove(LastAckedMove);
+}
+
 void FSavedMove_My::SetMoveFor(ACharacter* Character, float InDeltaTime, FVector const& NewAccel, class FNetworkPredictionData_Client_Character& ClientData)
 {
 	Super::SetMoveFor(Character, InDeltaTime, NewAccel, ClientData);
@@ -2511,13 +3729,269 @@ void FSavedMove_My::PrepMoveFor(class ACharacter* Character)
 	}
 }
 
+uint16 FSavedMove_My::GetParkourInputFlags() const
+{
+	uint16 Flags = EParkourInputFlags::None;
+
+	if (SavedMove1)
+		Flags |= EParkourInputFlags::WallRun;
+	if (SavedMove2)
+		Flags |= EParkourInputFlags::Slide;
+	if (SavedMove3)
+		Flags |= EParkourInputFlags::VerticalWallRun;
+	if (SavedMove4)
+		Flags |= EParkourInputFlags::ZiplineLadder;
+	if (SavedWantsToCustomJump)
+		Flags |= EParkourInputFlags::CustomJump;
+	if (SavedWantsToVerticalWallRunRotate)
+		Flags |= EParkourInputFlags::VerticalWallRunRotate;
+	if (SavedWantsToClimbLadderUp)
+		Flags |= EParkourInputFlags::ClimbLadderUp;
+	if (SavedWantsToClimbLadderDown)
+		Flags |= EParkourInputFlags::ClimbLadderDown;
+	if (SavedWantsToStopLedgeHang)
+		Flags |= EParkourInputFlags::StopLedgeHang;
+	if (SavedWantsToClimbLedge)
+		Flags |= EParkourInputFlags::ClimbLedge;
+
+	return Flags;
+}
+
+void FParkourNetworkMoveData::ClientFillNetworkMoveData(const FSavedMove_Character& ClientMove, ENetworkMoveType MoveType)
+{
+	Super::ClientFillNetworkMoveData(ClientMove, MoveType);
+
+	ParkourFlags = static_cast<const FSavedMove_My&>(ClientMove).GetParkourInputFlags() & EParkourInputFlags::NetworkMoveData;
+}
+
+bool FParkourNetworkMoveData::Serialize(UCharacterMovementComponent& CharacterMovement, FArchive& Ar, UPackageMap* PackageMap, ENetworkMoveType MoveType)
+{
+	Super::Serialize(CharacterMovement, Ar, PackageMap, MoveType);
+
+	// The six network move data intents are bits 4-9 of EParkourInputFlags, so they fit in 6 bits
+	uint8 PackedFlags = ParkourFlags >> 4;
+	Ar.SerializeBits(&PackedFlags, 6);
+	ParkourFlags = (uint16(PackedFlags) << 4) & EParkourInputFlags::NetworkMoveData;
+
+	return !Ar.IsError();
+}
+
+void FParkourMoveResponseDataContainer::ServerFillResponseData(const UCharacterMovementComponent& CharacterMovement, const FClientAdjustment& PendingAdjustment)
+{
+	Super::ServerFillResponseData(CharacterMovement, PendingAdjustment);
+
+	const UParkourMovementComponent& ParkourMovement = static_cast<const UParkourMovementComponent&>(CharacterMovement);
+
+	bHasParkourState = !IsGoodMove() && ParkourMovement.MovementMode == MOVE_Custom;
+
+	if (!bHasParkourState)
+	{
+		return;
+	}
+
+	ParkourMode = ParkourMovement.CustomMovementMode;
+	RailActor = nullptr;
+	PackedNormal = 0;
+	bWallOnRight = false;
+	LedgeHeight = 0.f;
+
+	switch (ParkourMode)
+	{
+	case ECustomMovementMode::CMOVE_WallRunning:
+	{
+		PackedNormal = ParkourQuantize::PackNormal16(ParkourMovement.WallRunNormal);
+		bWallOnRight = ParkourMovement.IsWallRunningR;
+
+		break;
+	}
+	case ECustomMovementMode::CMOVE_VerticalWallRunning:
+	{
+		PackedNormal = ParkourQuantize::PackNormal16(ParkourMovement.VerticalWallRunNormal);
+
+		break;
+	}
+	case ECustomMovementMode::CMOVE_Ziplining:
+	{
+		RailActor = ParkourMovement.CurrentZipline.Get();
+
+		break;
+	}
+	case ECustomMovementMode::CMOVE_ClimbLadder:
+	{
+		RailActor = ParkourMovement.CurrentLadder.Get();
+		PackedNormal = ParkourQuantize::PackNormal16(ParkourMovement.LadderNormal);
+
+		break;
+	}
+	case ECustomMovementMode::CMOVE_LedgeHang:
+	{
+		PackedNormal = ParkourQuantize::PackNormal16(ParkourMovement.LedgeNormal);
+		LedgeHeight = ParkourMovement.LedgeHeight;
+
+		break;
+	}
+	}
+}
+
+bool FParkourMoveResponseDataContainer::Serialize(UCharacterMovementComponent& CharacterMovement, FArchive& Ar, UPackageMap* PackageMap)
+{
+	if (!Super::Serialize(CharacterMovement, Ar, PackageMap))
+	{
+		return false;
+	}
+
+	if (IsGoodMove())
+	{
+		bHasParkourState = false;
+		return !Ar.IsError();
+	}
+
+	Ar.SerializeBits(&bHasParkourState, 1);
+
+	if (!bHasParkourState)
+	{
+		return !Ar.IsError();
+	}
+
+	// Custom modes fit in 4 bits
+	Ar.SerializeBits(&ParkourMode, 4);
+
+	switch (ParkourMode)
+	{
+	case ECustomMovementMode::CMOVE_WallRunning:
+	{
+		Ar << PackedNormal;
+		Ar.SerializeBits(&bWallOnRight, 1);
+
+		break;
+	}
+	case ECustomMovementMode::CMOVE_VerticalWallRunning:
+	{
+		Ar << PackedNormal;
+
+		break;
+	}
+	case ECustomMovementMode::CMOVE_Ziplining:
+	{
+		UObject* RailObject = RailActor;
+		Ar << RailObject;
+		RailActor = Cast<AActor>(RailObject);
+
+		break;
+	}
+	case ECustomMovementMode::CMOVE_ClimbLadder:
+	{
+		UObject* RailObject = RailActor;
+		Ar << RailObject;
+		RailActor = Cast<AActor>(RailObject);
+		Ar << PackedNormal;
+
+		break;
+	}
+	case ECustomMovementMode::CMOVE_LedgeHang:
+	{
+		Ar << PackedNormal;
+		ParkourQuantize::SerializeHeight(Ar, LedgeHeight);
+
+		break;
+	}
+	}
+
+	return !Ar.IsError();
+}
+
+FParkourNetworkMoveDataContainer::FParkourNetworkMoveDataContainer()
+{
+	NewMoveData = &ParkourMoveData[0];
+	PendingMoveData = &ParkourMoveData[1];
+	OldMoveData = &ParkourMoveData[2];
+}
+
+namespace ParkourSavedMovePool
+{
+	// Shared pointer reference controller that is placed in the same pooled block as the move it counts references to, the way
+	// MakeShared puts them in a single allocation. A custom deleter would need a controller of its own from the general allocator.
+	class FPooledMoveController : public SharedPointerInternals::FReferenceControllerBase
+	{
+	public:
+		static FPooledMoveController* Allocate(const TSharedRef<FParkourSlabPool>& Pool);
+
+		// The shared pointer deletes its controller once the last weak reference is gone, that hands the block back to the pool
+		static void operator delete(void* Controller);
+
+		virtual void DestroyObject() override
+		{
+			GetMove()->~FSavedMove_My();
+		}
+
+		FSavedMove_My* GetMove()
+		{
+			return reinterpret_cast<FSavedMove_My*>(&MoveStorage);
+		}
+
+	private:
+		FPooledMoveController()
+		{
+			new (&MoveStorage) FSavedMove_My();
+		}
+
+		TTypeCompatibleBytes<FSavedMove_My> MoveStorage;
+	};
+
+	// Comes before the controller in its block and keeps the pool alive while the block is handed out. It is kept outside of the
+	// controller so operator delete can still read it once the controller has been destroyed.
+	struct FBlockHeader
+	{
+		TSharedPtr<FParkourSlabPool> Pool;
+	};
+
+	constexpr SIZE_T ControllerOffset = (sizeof(FBlockHeader) + alignof(FPooledMoveController) - 1) / alignof(FPooledMoveController) * alignof(FPooledMoveController);
+	constexpr SIZE_T BlockSize = ControllerOffset + sizeof(FPooledMoveController);
+
+	FPooledMoveController* FPooledMoveController::Allocate(const TSharedRef<FParkourSlabPool>& Pool)
+	{
+		uint8* Block = static_cast<uint8*>(Pool->Allocate());
+
+		new (Block) FBlockHeader{ Pool };
+
+		return new (Block + ControllerOffset) FPooledMoveController();
+	}
+
+	void FPooledMoveController::operator delete(void* Controller)
+	{
+		uint8* Block = static_cast<uint8*>(Controller) - ControllerOffset;
+		FBlockHeader* Header = reinterpret_cast<FBlockHeader*>(Block);
+
+		// Hold on to the pool until the block is back on its free list, this may be the last reference to it
+		const TSharedPtr<FParkourSlabPool> Pool = MoveTemp(Header->Pool);
+		Header->~FBlockHeader();
+
+		Pool->Free(Block);
+	}
+}
+
 FNetworkPredictionData_Client_My::FNetworkPredictionData_Client_My(const UCharacterMovementComponent& ClientMovement)
 	: Super(ClientMovement)
+	, SavedMovePool(MakeShared<FParkourSlabPool>(ParkourSavedMovePool::BlockSize, SavedMovesPerSlab))
 {
 
 }
 
 FSavedMovePtr FNetworkPredictionData_Client_My::AllocateNewMove()
 {
-	return FSavedMovePtr(new FSavedMove_My());
+	if (SavedMovePool->HasFreeBlock())
+	{
+		INC_DWORD_STAT(STAT_ParkourSavedMovePoolHits);
+	}
+	else
+	{
+		INC_DWORD_STAT(STAT_ParkourSavedMovePoolMisses);
+	}
+
+	ParkourSavedMovePool::FPooledMoveController* Controller = ParkourSavedMovePool::FPooledMoveController::Allocate(SavedMovePool);
+
+	SET_DWORD_STAT(STAT_ParkourSavedMovePoolHighWater, SavedMovePool->GetHighWaterMark());
+
+	// The move and its reference count come out of the same block, nothing is left for the general allocator
+	return UE4SharedPointer_Private::MakeSharedRef<FSavedMove_Character, ESPMode::Fast>(Controller->GetMove(), Controller);
 }
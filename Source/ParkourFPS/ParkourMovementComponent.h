@@ -5,14 +5,212 @@
 #include "CoreMinimal.h"
 #include "GameFramework/CharacterMovementComponent.h"
 #include "ParkourFPSCharacter.h"
+#include "ParkourLog.h"
+#include "ParkourCorrectionRecorder.h"
+#include "ParkourMoveRecording.h"
+#include "ParkourRpcAccounting.h"
+#include "ParkourSlabPool.h"
 #include "ParkourMovementComponent.generated.h"
 
 /**
  * 
  */
 
-DECLARE_LOG_CATEGORY_EXTERN(LogMovementCorrections, Log, All);
-DECLARE_LOG_CATEGORY_EXTERN(LogParkourMovement, Log, All);
+// Parkour intents packed into a single bitmask
+namespace EParkourInputFlags
+{
+	enum Type : uint16
+	{
+		None					= 0,
+		WallRun					= 1 << 0,
+		Slide					= 1 << 1,
+		VerticalWallRun			= 1 << 2,
+		ZiplineLadder			= 1 << 3,
+		CustomJump				= 1 << 4,
+		VerticalWallRunRotate	= 1 << 5,
+		ClimbLadderUp			= 1 << 6,
+		ClimbLadderDown			= 1 << 7,
+		StopLedgeHang			= 1 << 8,
+		ClimbLedge				= 1 << 9,
+
+		// Intents carried in FParkourNetworkMoveData, the rest travel in the saved move's compressed flags
+		NetworkMoveData			= CustomJump | VerticalWallRunRotate | ClimbLadderUp | ClimbLadderDown | StopLedgeHang | ClimbLedge,
+	};
+}
+
+/** Number of scene queries a parkour movement component issued during one tick */
+USTRUCT(BlueprintType)
+struct FParkourSceneQueryCounters
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "Scene Queries")
+	int32 LineTraces = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Scene Queries")
+	int32 Sweeps = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Scene Queries")
+	int32 FloorQueries = 0;
+
+	/** Probes that were pushed to the next move because the move had used up its scene query budget */
+	UPROPERTY(BlueprintReadOnly, Category = "Scene Queries")
+	int32 DeferredProbes = 0;
+
+	int32 GetTotal() const { return LineTraces + Sweeps + FloorQueries; }
+};
+
+/** Client position error the server accepts without a correction while in a parkour mode */
+USTRUCT(BlueprintType)
+struct FParkourErrorTolerance
+{
+	GENERATED_BODY()
+
+	/** Position error in cm that is always accepted */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Network")
+	float PositionTolerance = 0.f;
+
+	/** Additional position error in cm accepted per second of move time, for modes where client and server drift apart at a steady rate */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Network")
+	float DriftTolerance = 0.f;
+
+	FParkourErrorTolerance() {}
+	FParkourErrorTolerance(float InPositionTolerance, float InDriftTolerance) : PositionTolerance(InPositionTolerance), DriftTolerance(InDriftTolerance) {}
+};
+
+// How hard the current movement is for remote viewers to follow, drives the character's net update frequency and priority
+enum class EParkourNetDynamics : uint8
+{
+	// Ziplines, ladders and ledge hangs, which proxies extrapolate or which barely move
+	Predictable,
+	Normal,
+	// Wall runs, slides, ledge climbs and vaults
+	High,
+};
+
+// Tick cost of a parkour movement component in one movement mode, accumulated since the last ResetTickCycles
+struct FParkourModeTickCost
+{
+	int32 Ticks = 0;
+	uint64 Cycles = 0;
+	int32 MaxSceneQueries = 0;
+};
+
+// A blocking hit that OnActorHit classified without starting any parkour move. Further hits with the same key are skipped until it expires.
+struct FParkourHitCacheEntry
+{
+	TWeakObjectPtr<const UPrimitiveComponent> Component;
+
+	// Impact normal in eighths, character location relative to the hit component in OnActorHitCachePositionBucket sized cells and
+	// character yaw in OnActorHitCacheYawBucket sized cells
+	FIntVector NormalBucket = FIntVector::ZeroValue;
+	FIntVector PositionBucket = FIntVector::ZeroValue;
+	int32 YawBucket = 0;
+
+	// Parkour input flags and movement mode the hit was classified with, any change can make a different move possible
+	uint16 InputFlags = 0;
+	uint8 MovementMode = 0;
+	uint8 CustomMovementMode = 0;
+
+	float Time = -1.f;
+
+	bool Matches(const FParkourHitCacheEntry& Other) const
+	{
+		return Component == Other.Component && NormalBucket == Other.NormalBucket && PositionBucket == Other.PositionBucket && YawBucket == Other.YawBucket &&
+			InputFlags == Other.InputFlags && MovementMode == Other.MovementMode && CustomMovementMode == Other.CustomMovementMode;
+	}
+};
+
+// The wall a wall run is running along, captured from a wall run trace so that following ticks can check contact against the plane
+// instead of tracing for it again.
+struct FParkourWallPlane
+{
+	TWeakObjectPtr<const UPrimitiveComponent> Component;
+
+	FVector Point = FVector::ZeroVector;
+	FVector Normal = FVector::ZeroVector;
+
+	// Distance from the character to the plane when it was captured
+	float Distance = 0.f;
+
+	// MoveTimeSeconds when the plane was traced
+	float TraceMoveTime = 0.f;
+
+	bool Valid = false;
+};
+
+// The vertical trace in front of the capsule that the ledge hang, climb and quick climb checks classify. Taken at most once per
+// movement update, the capsule sweep that checks there is room to stand on the ledge and the forward trace for the wall's normal
+// only when a check needs them.
+struct FParkourLedgeProbe
+{
+	bool Valid = false;
+
+	// Where the character was and which way it faced when the probe was traced, it is only reused from the same place
+	FVector Location = FVector::ZeroVector;
+	FVector Forward = FVector::ZeroVector;
+
+	bool SurfaceFound = false;
+	FHitResult Hit;
+
+	// Height of the surface above the bottom of the trace
+	float SurfaceHeight = 0.f;
+
+	bool ClearanceChecked = false;
+	bool Clear = false;
+
+	// Normal of the wall below the ledge, facing towards the character
+	bool WallNormalChecked = false;
+	FVector WallNormal = FVector::ZeroVector;
+};
+
+class AZipline;
+class ALadder;
+
+// Sends the parkour intents that don't fit in the compressed flags with every ServerMove, so the server replays them on the same move as the client
+class FParkourNetworkMoveData : public FCharacterNetworkMoveData
+{
+public:
+	typedef FCharacterNetworkMoveData Super;
+
+	// EParkourInputFlags::NetworkMoveData bits of the move
+	uint16 ParkourFlags = 0;
+
+	virtual void ClientFillNetworkMoveData(const FSavedMove_Character& ClientMove, ENetworkMoveType MoveType) override;
+	virtual bool Serialize(UCharacterMovementComponent& CharacterMovement, FArchive& Ar, UPackageMap* PackageMap, ENetworkMoveType MoveType) override;
+};
+
+class FParkourNetworkMoveDataContainer : public FCharacterNetworkMoveDataContainer
+{
+public:
+	FParkourNetworkMoveDataContainer();
+
+	FParkourNetworkMoveData ParkourMoveData[3];
+};
+
+// Adds the state of the current parkour mode to corrections, so the client can restore it directly instead of re-running probes
+// while it replays its moves.
+class FParkourMoveResponseDataContainer : public FCharacterMoveResponseDataContainer
+{
+public:
+	typedef FCharacterMoveResponseDataContainer Super;
+
+	virtual void ServerFillResponseData(const UCharacterMovementComponent& CharacterMovement, const FClientAdjustment& PendingAdjustment) override;
+	virtual bool Serialize(UCharacterMovementComponent& CharacterMovement, FArchive& Ar, UPackageMap* PackageMap) override;
+
+	// Only set for corrections in a custom movement mode
+	bool bHasParkourState = false;
+	uint8 ParkourMode = 0;
+
+	// Zipline or ladder the character is on
+	AActor* RailActor = nullptr;
+
+	// Wall run, vertical wall run, ledge or ladder normal packed with ParkourQuantize::PackNormal16
+	uint16 PackedNormal = 0;
+
+	bool bWallOnRight = false;
+	float LedgeHeight = 0.f;
+};
 
 UCLASS()
 class PARKOURFPS_API UParkourMovementComponent : public UCharacterMovementComponent
@@ -20,6 +218,8 @@ class PARKOURFPS_API UParkourMovementComponent : public UCharacterMovementCompon
 	GENERATED_UCLASS_BODY()
 
 	friend class FSavedMove_My;
+	friend class FParkourMoveResponseDataContainer;
+	friend class FParkourMovementTestWorld;
 
 private:
 	int ClientRootCount;
@@ -49,6 +249,120 @@ private:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Custom Character Movement", Meta = (AllowPrivateAccess = "true"))
 	bool DrawDebug = true;
 
+	// ========================= NETWORK VARIABLES =======================================
+
+	// Minimum time between ServerMoves while wall running, ziplining or climbing a ladder. Inputs rarely change in these modes, so moves
+	// are held back and combined for longer. A move that changes a parkour intent is never held back (see CanDelaySendingMove).
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Custom Character Movement|Network", Meta = (AllowPrivateAccess = "true", ClampMin = "0"))
+	float StableModeNetSendDeltaTime = 0.05;
+
+	// Seconds between rail anchor refreshes while the motion along the rail doesn't change, bounds the proxies' extrapolation drift
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Custom Character Movement|Network", Meta = (AllowPrivateAccess = "true", ClampMin = "0.1"))
+	float RailReanchorInterval = 1.f;
+
+	// Smoothing mode a simulated proxy used before it switched to linear smoothing on a rail, restored when it leaves the rail
+	ENetworkSmoothingMode SmoothingModeBeforeRail = ENetworkSmoothingMode::Exponential;
+	bool RailSmoothingApplied = false;
+
+	// Per mode position error the server accepts before correcting the client. Modes without an entry use the engine's
+	// p.MaxPositionErrorSquared. Wall runs re-trace their direction every tick, so client and server drift apart slightly.
+	// The server keeps its own position for accepted moves, the client is corrected once the drift exceeds the tolerance.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Custom Character Movement|Network", Meta = (AllowPrivateAccess = "true"))
+	FParkourErrorTolerance WallRunErrorTolerance = FParkourErrorTolerance(5.f, 50.f);
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Custom Character Movement|Network", Meta = (AllowPrivateAccess = "true"))
+	FParkourErrorTolerance VerticalWallRunErrorTolerance = FParkourErrorTolerance(5.f, 50.f);
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Custom Character Movement|Network", Meta = (AllowPrivateAccess = "true"))
+	FParkourErrorTolerance SlideErrorTolerance = FParkourErrorTolerance(3.f, 30.f);
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Custom Character Movement|Network", Meta = (AllowPrivateAccess = "true"))
+	FParkourErrorTolerance ZiplineErrorTolerance = FParkourErrorTolerance(5.f, 0.f);
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Custom Character Movement|Network", Meta = (AllowPrivateAccess = "true"))
+	FParkourErrorTolerance LadderErrorTolerance = FParkourErrorTolerance(2.f, 0.f);
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Custom Character Movement|Network", Meta = (AllowPrivateAccess = "true"))
+	FParkourErrorTolerance LedgeHangErrorTolerance = FParkourErrorTolerance(2.f, 0.f);
+
+	// Corrections that the tolerances above suppressed, indexed by ECustomMovementMode
+	TArray<int32> SuppressedCorrections;
+
+	// ========================= SCENE QUERY VARIABLES =======================================
+
+	// When enabled, optional probes are deferred to the next move once SceneQueryBudgetPerMove has been used up. The budget is per move
+	// rather than per tick so the server, which can run several ServerMoves for a character in one tick, defers the same probes the client did.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Custom Character Movement|Scene Queries", Meta = (AllowPrivateAccess = "true"))
+	bool EnforceSceneQueryBudget = false;
+
+	// Includes the sweeps that move the capsule
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Custom Character Movement|Scene Queries", Meta = (AllowPrivateAccess = "true", ClampMin = "0"))
+	int32 SceneQueryBudgetPerMove = 16;
+
+	// Length of the downward sweep that refreshes a stale floor sample, it only has to reach floors right under the capsule
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Custom Character Movement|Scene Queries", Meta = (AllowPrivateAccess = "true", ClampMin = "2.4"))
+	float FloorCacheSweepDistance = 10.0f;
+
+	// The custom modes share one floor sample kept in CurrentFloor. It is reused across moves for as long as it describes the floor
+	// under the capsule, and thrown away when the capsule moves, the movement mode changes, the character teleports or a correction
+	// is received.
+	bool CustomModeFloorValid = false;
+
+	// Mutable so that the const FindFloor override can count its queries
+	mutable FParkourSceneQueryCounters CurrentTickSceneQueries;
+	FParkourSceneQueryCounters LastTickSceneQueries;
+
+	// Queries since the current move started, checked against SceneQueryBudgetPerMove
+	mutable int32 CurrentMoveSceneQueries = 0;
+
+	bool LedgeProbesDeferred = false;
+
+	// Seconds of move time an OnActorHit classification that started nothing is reused for hits on the same component, normal, position and facing.
+	// 0 disables the cache.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Custom Character Movement|Scene Queries", Meta = (AllowPrivateAccess = "true", ClampMin = "0"))
+	float OnActorHitCacheLifetime = 0.1f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Custom Character Movement|Scene Queries", Meta = (AllowPrivateAccess = "true", ClampMin = "1"))
+	float OnActorHitCachePositionBucket = 50.f;
+
+	// Degrees of yaw per cell, turning towards or away from a wall can make a different move possible
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Custom Character Movement|Scene Queries", Meta = (AllowPrivateAccess = "true", ClampMin = "1"))
+	float OnActorHitCacheYawBucket = 15.f;
+
+	// Sum of the DeltaTime of every move performed. Unlike the world time it advances the same way on the client and on the server,
+	// which performs the moves the client sent with the client's DeltaTime.
+	float MoveTimeSeconds = 0.f;
+
+	static constexpr int32 NumHitCacheEntries = 4;
+
+	FParkourHitCacheEntry HitCache[NumHitCacheEntries];
+	int32 NextHitCacheEntry = 0;
+
+	// Cycles spent in TickComponent since the last ResetTickCycles, read by the ParkourBenchmark commandlet
+	uint64 AccumulatedTickCycles = 0;
+	int32 AccumulatedTicks = 0;
+
+	// Indexed by ECustomMovementMode, the last entry collects ticks outside of custom movement modes
+	TArray<FParkourModeTickCost> ModeTickCosts;
+
+	// ========================= CORRECTION RECORDING =======================================
+
+	FParkourCorrectionRecorder CorrectionRecorder;
+
+	// ========================= MOVE RECORDING =======================================
+
+	// Moves received from the owning client while p.Parkour.RecordMoves is set, written out when recording stops or at the first walking or
+	// falling move after the recording is full
+	FParkourMoveRecording MoveRecording;
+	bool RecordingMoves = false;
+
+	FParkourNetworkMoveDataContainer ParkourMoveDataContainer;
+	FParkourMoveResponseDataContainer ParkourMoveResponseDataContainer;
+
+	// ========================= RPC ACCOUNTING =======================================
+
+	FParkourRpcAccounting RpcAccounting;
+
 	// ========================= WALL RUNNING VARIABLES =======================================
 
 	bool IsWallRunning = false;
@@ -78,6 +392,21 @@ private:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Custom Character Movement|Wall Running", Meta = (AllowPrivateAccess = "true"))
 	float WallRunLineTraceVerticalTolerance = 50.0f;
 
+	// Seconds of move time a wall run checks contact against the cached wall plane before tracing for the wall again. 0 traces every move.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Custom Character Movement|Wall Running", Meta = (AllowPrivateAccess = "true", ClampMin = "0"))
+	float WallPlaneRetraceTime = 0.1f;
+
+	// How far along the wall from the traced hit point the plane is trusted. The trace only saw the face at that point, past it the
+	// wall may end or turn.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Custom Character Movement|Wall Running", Meta = (AllowPrivateAccess = "true", ClampMin = "0"))
+	float WallPlaneMaxDistance = 100.0f;
+
+	// How far the character may drift from the distance it had to the wall plane when it was captured
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Custom Character Movement|Wall Running", Meta = (AllowPrivateAccess = "true", ClampMin = "0"))
+	float WallPlaneDistanceTolerance = 10.0f;
+
+	FParkourWallPlane WallPlane;
+
 	// ========================= VERTICAL WALL RUN  VARIABLES =======================================
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Custom Character Movement|Vertical Wall Run ", Meta = (AllowPrivateAccess = "true"))
@@ -130,14 +459,18 @@ private:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Custom Character Movement|Zip line", Meta = (AllowPrivateAccess = "true"))
 	float ZiplineStartSpeed = 600.f;
 
+	// Acceleration along the zip line in cm/s^2. Replaces ZiplineAcceleration, which was added once per move, so overrides of that value
+	// in per move units aren't loaded into this one.
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Custom Character Movement|Zip line", Meta = (AllowPrivateAccess = "true"))
-	float ZiplineAcceleration = 20.f;
+	float ZiplineAccelerationPerSecond = 1200.f;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Custom Character Movement|Zip line", Meta = (AllowPrivateAccess = "true"))
 	float ZiplineMaxSpeed = 1200.f;
 
 	bool IsZiplining = false;
 
+	TWeakObjectPtr<AZipline> CurrentZipline;
+
 	FVector ZiplineStart;
 	FVector ZiplineEnd;
 	FVector ZiplineDirection;
@@ -158,6 +491,8 @@ private:
 
 	bool IsClimbingLadder = false;
 
+	TWeakObjectPtr<ALadder> CurrentLadder;
+
 	FVector LadderTop;
 	FVector LadderBottom;
 	FVector LadderNormal;
@@ -196,6 +531,8 @@ private:
 	FVector LedgeNormal;
 	float LedgeHeight;
 
+	FParkourLedgeProbe LedgeProbe;
+
 	bool IsClimbingLedge = false;
 	bool ClimbQueued = false;
 	bool EndClimbQueued = false;
@@ -204,12 +541,73 @@ protected:
 	virtual void BeginPlay() override;
 	virtual void OnComponentDestroyed(bool bDestroyingHierarchy) override;
 
-	void LogClientCorrection(bool isServer, float TimeStamp, FVector NewLocation, FVector NewVelocity, uint8 ServerMovementMode);
+	void RecordClientCorrection(float TimeStamp, FVector NewLocation, FVector NewVelocity, uint8 ServerMovementMode);
 
 	AParkourFPSCharacter* GetParkourFPSCharacter();
 
+	// Scene query wrappers, these count every query against the per tick and per move counters
+	bool ParkourLineTrace(FHitResult& OutHit, const FVector& Start, const FVector& End, const FCollisionQueryParams& Params);
+	bool ParkourSweep(FHitResult& OutHit, const FVector& Start, const FVector& End, const FCollisionShape& Shape, const FCollisionQueryParams& Params);
+	bool HasSceneQueryBudget(int32 QueryCost) const;
+	void ResetSceneQueryCounters();
+
+	// Counts the sweeps that move the capsule, e.g. from SafeMoveUpdatedComponent
+	virtual bool MoveUpdatedComponentImpl(const FVector& Delta, const FQuat& NewRotation, bool bSweep, FHitResult* OutHit = nullptr, ETeleportType Teleport = ETeleportType::None) override;
+
+	// Bits waiting in the owning connection's send buffer, used to measure the size of each server RPC
+	int64 GetPendingSendBits() const;
+	void RecordRpcSent(EParkourRpc::Type Rpc, int64 SendBitsBefore);
+
+	virtual float GetClientNetSendDeltaTime(const APlayerController* PC, const FNetworkPredictionData_Client_Character* ClientData, const FSavedMovePtr& NewMove) const override;
+
+	// Sends a move that changes any parkour intent right away instead of holding it back for the net send delta time
+	virtual bool CanDelaySendingMove(const FSavedMovePtr& NewMove) override;
+
+	// Wall running, ziplining and ladder climbing, where parkour inputs stay constant for long stretches
+	bool IsInStableParkourMode() const;
+
+	virtual bool ServerExceedsAllowablePositionError(float ClientTimeStamp, float DeltaTime, const FVector& Accel, const FVector& ClientWorldLocation,
+		const FVector& RelativeClientLocation, UPrimitiveComponent* ClientMovementBase, FName ClientBaseBoneName, uint8 ClientMovementMode) override;
+
+	// Returns null for modes that use the engine's default error check
+	const FParkourErrorTolerance* GetErrorTolerance(uint8 InCustomMovementMode) const;
+
+	virtual void SimulateMovement(float DeltaTime) override;
+
+	// Simulated proxies on a zipline or ladder follow the path analytically instead of simulating it. Returns false if not on a rail.
+	bool SimulateRailMovement(float DeltaTime);
+
+	// Server side, anchors the proxies' rail extrapolation at the current location
+	void UpdateRailAnchor(AActor* Rail, float AlongRailSpeed, float AlongRailAcceleration, float MaxSpeed);
+	void ClearRailAnchor();
+	bool IsRailAnchorStale(const AActor* Rail) const;
+
+	virtual void ClientHandleMoveResponse(const FCharacterMoveResponseDataContainer& MoveResponse) override;
+
+	// Restores the mode specific state sent with a correction, without running any probes
+	void RestoreParkourState(const FParkourMoveResponseDataContainer& MoveResponse);
+
+	virtual void MoveAutonomous(float ClientTimeStamp, float DeltaTime, uint8 CompressedFlags, const FVector& NewAccel) override;
+
+	// A recording only stores the start transform, velocity and mode, so it can only start while walking or falling with no other parkour
+	// state to carry over
+	bool CanStartMoveRecording() const;
+	void StartMoveRecording();
+	void RecordAutonomousMove(float ClientTimeStamp, float DeltaTime, uint8 CompressedFlags, const FVector& NewAccel, uint16 ParkourFlags);
+
+	// Hands the recorded moves to a worker thread that writes them to Saved/ParkourRecordings, and clears them
+	void FlushMoveRecording();
+
+	virtual void CallServerMove(const FSavedMove_Character* NewMove, const FSavedMove_Character* OldMove) override;
+	virtual void CallServerMovePacked(const FSavedMove_Character* NewMove, const FSavedMove_Character* PendingMove, const FSavedMove_Character* OldMove) override;
+
 	void SetCameraRotationLimit(float MinPitch, float MaxPitch, float MinRoll, float MaxRoll, float MinYaw, float MaxYaw);
 
+	// Runs the ledge, zipline, ladder and wall run checks for a blocking hit
+	void ClassifyActorHit(AActor* OtherActor, const FHitResult& Hit);
+
+	FParkourHitCacheEntry MakeHitCacheEntry(const FHitResult& Hit) const;
+
 	bool IsWalkingForward();
 
 	float GetAngleBetweenVectors(FVector Vector1, FVector Vector2);
@@ -220,6 +618,7 @@ protected:
 	// Wall Running Functions
 	bool CheckCanWallRun(const FHitResult Hit);
 	bool CheckWallRunFloor(float Distance);
+	const FFindFloorResult& GetCustomModeFloor();
 	bool CheckWallRunTraces();
 	FVector GetWallRunEndVectorL();
 	FVector GetWallRunEndVectorR();
@@ -229,6 +628,8 @@ protected:
 	void EndWallRun();
 	void PhysWallRun(float deltaTime, int32 Iterations);
 	bool IsNextToWall(float vertical_tolerance = 0.0f);
+	void CacheWallPlane(const FHitResult& Hit);
+	bool IsNextToWallPlane();
 	bool CanSurfaceBeWallRan(const FVector& surface_normal) const;
 	int FindWallRunSide(const FVector& surface_normal);
 
@@ -275,10 +676,16 @@ protected:
 	void PhysClimbLadder(float DeltaTime, int32 Iterations);
 
 	// Climbing Functions
+	void RunLedgeProbes();
 	ELedgeState GetStateOfLedge();
 	bool CheckCanHangLedge();
 	bool CheckCanClimb();
 	bool CheckCanClimbToHit(FHitResult Hit);
+
+	// Shared by the ledge checks, the probe is invalidated at the start of every movement update
+	const FParkourLedgeProbe& GetLedgeProbe();
+	bool GetLedgeProbeClearance();
+	const FVector& GetLedgeProbeWallNormal();
 	bool CheckCanQuickClimb();
 	bool CheckCanVault();
 
@@ -299,15 +706,15 @@ public:
 	virtual void PhysCustom(float deltaTime, int32 Iterations) override;
 	virtual void UpdateCharacterStateBeforeMovement(float DeltaSeconds) override;
 	virtual void OnMovementModeChanged(EMovementMode PreviousMovementMode, uint8 PreviousCustomMode) override;
+	virtual bool IsMovingOnGround() const override;
+	virtual void OnTeleported() override;
 	virtual void OnMovementUpdated(float DeltaSeconds, const FVector& OldLocation, const FVector& OldVelocity) override;
 	virtual FNetworkPredictionData_Client* GetPredictionData_Client() const override;
+	virtual void FindFloor(const FVector& CapsuleLocation, FFindFloorResult& OutFloorResult, bool bCanUseCachedLocation, const FHitResult* DownwardSweepResult = NULL) const override;
 
 	virtual void OnClientCorrectionReceived(class FNetworkPredictionData_Client_Character& ClientData, float TimeStamp, FVector NewLocation, FVector NewVelocity,
 	UPrimitiveComponent* NewBase, FName NewBaseBoneName, bool bHasBase, bool bBaseRelativePosition, uint8 ServerMovementMode) override;
 
-	virtual void ClientAdjustPosition(float TimeStamp, FVector NewLoc, FVector NewVel, UPrimitiveComponent* NewBase, FName NewBaseBoneName, bool bHasBase,
-	bool bBaseRelativePosition, uint8 ServerMovementMode) override;
-
 
 	UFUNCTION(BlueprintCallable, Category = "Movement")
 	void SetMovementKey1Down(bool KeyIsDown);
@@ -321,15 +728,9 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Movement")
 	void SetWantsToCustomJump(bool KeyIsDown);
 
-	UFUNCTION(Unreliable, Server, WithValidation)
-	void ServerSetWantsToCustomJump(const bool WantsToJump);
-
 	UFUNCTION(BlueprintCallable, Category = "Movement")
 	void SetWantsToVerticalWallRunRotate(bool KeyIsDown);
 
-	UFUNCTION(Unreliable, Server, WithValidation)
-	void ServerSetWantsToVerticalWallRunRotate(const bool WantsToRotate);
-
 	UFUNCTION(BlueprintCallable, Category = "Movement")
 	void SetWantsToStopZipline(bool KeyIsDown);
 
@@ -339,26 +740,51 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Movement")
 	void SetWantsToGoDownLadder(bool KeyIsDown);
 
-	UFUNCTION(Unreliable, Server, WithValidation)
-	void ServerSetWantsToGoUpLadder(const bool WantsToGoUp);
-
-	UFUNCTION(Unreliable, Server, WithValidation)
-	void ServerSetWantsToGoDownLadder(const bool WantsToGoDown);
-
 	UFUNCTION(BlueprintCallable, Category = "Movement")
 	void SetWantsToStopLedgeHang(bool KeyIsDown);
 
-	UFUNCTION(Unreliable, Server, WithValidation)
-	void ServerSetWantsToStopLedgeHang(const bool WantsToStop);
-
 	UFUNCTION(BlueprintCallable, Category = "Movement")
 	void SetWantsToClimbLedge(bool KeyIsDown);
 
-	UFUNCTION(Unreliable, Server, WithValidation)
-	void ServerSetWantsToClimbLedge(const bool WantsToClimb);
-
 
 	bool IsCustomMovementMode(uint8 custom_movement_mode) const;
+
+	// Returns the current parkour intents as EParkourInputFlags
+	uint16 GetParkourInputFlags() const;
+
+	// Applies the EParkourInputFlags::NetworkMoveData intents received with a move
+	void ApplyNetworkMoveDataFlags(uint16 Flags);
+
+	EParkourNetDynamics GetNetDynamics() const;
+
+	// Packs the current mode into the state replicated to simulated proxies
+	FParkourReplicatedState BuildReplicatedParkourState() const;
+
+	// Called on simulated proxies when their replicated parkour state changes
+	void ApplyReplicatedParkourState(const FParkourReplicatedState& State);
+
+	// Writes the correction flight recorder to a binary file
+	bool DumpCorrectionRecorder(const FString& Filename) const;
+
+	// Re-simulates a recorded move the way the server ran it, returns the scene queries the move issued
+	int32 ReplayRecordedMove(const FParkourRecordedMove& Move);
+
+	// Returns the average milliseconds spent in TickComponent since the last ResetTickCycles
+	double GetAverageTickMs() const;
+
+	void ResetTickCycles();
+
+	const TArray<FParkourModeTickCost>& GetModeTickCosts() const;
+
+	// Number of corrections each custom mode's error tolerance suppressed on the server, indexed by ECustomMovementMode
+	const TArray<int32>& GetSuppressedCorrections() const;
+
+	// Server RPC calls and bytes per second sent by this character's owning connection
+	const FParkourRpcAccounting& GetRpcAccounting() const;
+
+	/** Returns the scene queries issued during the last completed tick */
+	UFUNCTION(BlueprintPure, Category = "Movement")
+	FParkourSceneQueryCounters GetLastTickSceneQueries() const;
 };
 
 class FSavedMove_My : public FSavedMove_Character
@@ -377,12 +803,18 @@ public:
 	// Basically you just check to make sure that the saved variables are the same.
 	virtual bool CanCombineWith(const FSavedMovePtr& NewMovePtr, ACharacter* Character, float MaxDelta) const override;
 
+	// Moves that change any parkour intent are resent with the next ServerMove until the server acknowledges them.
+	virtual bool IsImportantMove(const FSavedMovePtr& LastAckedMove) const override;
+
 	// Sets up the move before sending it to the server. 
 	virtual void SetMoveFor(ACharacter* Character, float InDeltaTime, FVector const& NewAccel, class FNetworkPredictionData_Client_Character& ClientData) override;
 
 	// Sets variables on character movement component before making a predictive correction.
 	virtual void PrepMoveFor(class ACharacter* Character) override;
 
+	// Returns the saved intents as EParkourInputFlags
+	uint16 GetParkourInputFlags() const;
+
 private:
 	uint8 SavedMove1 : 1;
 	uint8 SavedMove2 : 1;
@@ -409,6 +841,16 @@ public:
 
 	//brief Allocates a new copy of our custom saved move
 	virtual FSavedMovePtr AllocateNewMove() override;
+
+	const FParkourSlabPool& GetSavedMovePool() const { return *SavedMovePool; }
+
+private:
+	// A third of the engine's default MaxSavedMoveCount, so a client at a high frame rate needs a few slabs rather than one per move
+	static constexpr int32 SavedMovesPerSlab = 32;
+
+	// Moves are constructed in pooled blocks together with their shared pointer reference controller instead of with new. Each block
+	// holds a reference so the pool outlives any move still referenced after this prediction data is gone.
+	TSharedRef<FParkourSlabPool> SavedMovePool;
 };
 
 
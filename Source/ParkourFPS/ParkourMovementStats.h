@@ -0,0 +1,87 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+
+// Stats for the parkour movement component. View them in game with "stat ParkourMovement".
+DECLARE_STATS_GROUP(TEXT("ParkourMovement"), STATGROUP_ParkourMovement, STATCAT_Advanced);
+
+// ========================= PHYS FUNCTIONS =======================================
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("PhysWallRun"), STAT_ParkourPhysWallRun, STATGROUP_ParkourMovement, PARKOURFPS_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("PhysVerticalWallRun"), STAT_ParkourPhysVerticalWallRun, STATGROUP_ParkourMovement, PARKOURFPS_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("PhysSlide"), STAT_ParkourPhysSlide, STATGROUP_ParkourMovement, PARKOURFPS_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("PhysZipline"), STAT_ParkourPhysZipline, STATGROUP_ParkourMovement, PARKOURFPS_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("PhysClimbLadder"), STAT_ParkourPhysClimbLadder, STATGROUP_ParkourMovement, PARKOURFPS_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("PhysLedgeHang"), STAT_ParkourPhysLedgeHang, STATGROUP_ParkourMovement, PARKOURFPS_API);
+
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("PhysWallRun Calls"), STAT_ParkourPhysWallRunCalls, STATGROUP_ParkourMovement, PARKOURFPS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("PhysVerticalWallRun Calls"), STAT_ParkourPhysVerticalWallRunCalls, STATGROUP_ParkourMovement, PARKOURFPS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("PhysSlide Calls"), STAT_ParkourPhysSlideCalls, STATGROUP_ParkourMovement, PARKOURFPS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("PhysZipline Calls"), STAT_ParkourPhysZiplineCalls, STATGROUP_ParkourMovement, PARKOURFPS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("PhysClimbLadder Calls"), STAT_ParkourPhysClimbLadderCalls, STATGROUP_ParkourMovement, PARKOURFPS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("PhysLedgeHang Calls"), STAT_ParkourPhysLedgeHangCalls, STATGROUP_ParkourMovement, PARKOURFPS_API);
+
+// ========================= PROBE FUNCTIONS =======================================
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("IsNextToWall"), STAT_ParkourIsNextToWall, STATGROUP_ParkourMovement, PARKOURFPS_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("CheckWallRunTraces"), STAT_ParkourCheckWallRunTraces, STATGROUP_ParkourMovement, PARKOURFPS_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("CheckCanHangLedge"), STAT_ParkourCheckCanHangLedge, STATGROUP_ParkourMovement, PARKOURFPS_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("CheckCanClimb"), STAT_ParkourCheckCanClimb, STATGROUP_ParkourMovement, PARKOURFPS_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("CheckCanQuickClimb"), STAT_ParkourCheckCanQuickClimb, STATGROUP_ParkourMovement, PARKOURFPS_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("CheckCanVault"), STAT_ParkourCheckCanVault, STATGROUP_ParkourMovement, PARKOURFPS_API);
+
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("IsNextToWall Calls"), STAT_ParkourIsNextToWallCalls, STATGROUP_ParkourMovement, PARKOURFPS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("CheckWallRunTraces Calls"), STAT_ParkourCheckWallRunTracesCalls, STATGROUP_ParkourMovement, PARKOURFPS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("CheckCanHangLedge Calls"), STAT_ParkourCheckCanHangLedgeCalls, STATGROUP_ParkourMovement, PARKOURFPS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("CheckCanClimb Calls"), STAT_ParkourCheckCanClimbCalls, STATGROUP_ParkourMovement, PARKOURFPS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("CheckCanQuickClimb Calls"), STAT_ParkourCheckCanQuickClimbCalls, STATGROUP_ParkourMovement, PARKOURFPS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("CheckCanVault Calls"), STAT_ParkourCheckCanVaultCalls, STATGROUP_ParkourMovement, PARKOURFPS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Wall Plane Cache Hits"), STAT_ParkourWallPlaneCacheHits, STATGROUP_ParkourMovement, PARKOURFPS_API);
+
+// ========================= EVENTS =======================================
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("OnActorHit"), STAT_ParkourOnActorHit, STATGROUP_ParkourMovement, PARKOURFPS_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("OnMovementUpdated"), STAT_ParkourOnMovementUpdated, STATGROUP_ParkourMovement, PARKOURFPS_API);
+
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("OnActorHit Calls"), STAT_ParkourOnActorHitCalls, STATGROUP_ParkourMovement, PARKOURFPS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("OnMovementUpdated Calls"), STAT_ParkourOnMovementUpdatedCalls, STATGROUP_ParkourMovement, PARKOURFPS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("OnActorHit Cache Hits"), STAT_ParkourOnActorHitCacheHits, STATGROUP_ParkourMovement, PARKOURFPS_API);
+
+// ========================= SCENE QUERIES =======================================
+
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Line Traces"), STAT_ParkourLineTraces, STATGROUP_ParkourMovement, PARKOURFPS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Sweeps"), STAT_ParkourSweeps, STATGROUP_ParkourMovement, PARKOURFPS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Floor Queries"), STAT_ParkourFloorQueries, STATGROUP_ParkourMovement, PARKOURFPS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Floor Cache Hits"), STAT_ParkourFloorCacheHits, STATGROUP_ParkourMovement, PARKOURFPS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Deferred Probes"), STAT_ParkourDeferredProbes, STATGROUP_ParkourMovement, PARKOURFPS_API);
+
+// ========================= SERVER RPCS =======================================
+
+// Sent by the owning client, see FParkourRpcAccounting. Parkour intents travel inside ServerMove as FParkourNetworkMoveData.
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("ServerMove Calls"), STAT_ParkourRpcServerMoveCalls, STATGROUP_ParkourMovement, PARKOURFPS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("ServerMove Bytes"), STAT_ParkourRpcServerMoveBytes, STATGROUP_ParkourMovement, PARKOURFPS_API);
+
+// ========================= CORRECTIONS =======================================
+
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Suppressed Corrections"), STAT_ParkourSuppressedCorrections, STATGROUP_ParkourMovement, PARKOURFPS_API);
+
+// ========================= SAVED MOVES =======================================
+
+// Saved moves come from a per client FParkourSlabPool once the engine's free list of moves runs dry
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Saved Move Pool Hits"), STAT_ParkourSavedMovePoolHits, STATGROUP_ParkourMovement, PARKOURFPS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Saved Move Pool Misses"), STAT_ParkourSavedMovePoolMisses, STATGROUP_ParkourMovement, PARKOURFPS_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Saved Move Pool High Water"), STAT_ParkourSavedMovePoolHighWater, STATGROUP_ParkourMovement, PARKOURFPS_API);
+
+// ========================= CSV PROFILER =======================================
+
+// Per frame movement cost for csvprofile captures, summarised by the ParkourPerfReport commandlet
+CSV_DECLARE_CATEGORY_MODULE_EXTERN(PARKOURFPS_API, ParkourMovement);
+
+// Times the enclosing scope and bumps the matching "<Stat>Calls" counter
+#define PARKOUR_SCOPE_CYCLE_COUNTER(Stat) \
+	SCOPE_CYCLE_COUNTER(Stat); \
+	INC_DWORD_STAT(Stat##Calls)
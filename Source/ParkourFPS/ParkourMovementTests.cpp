@@ -0,0 +1,623 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "ParkourBenchmarkCommandlet.h"
+#include "ParkourFPSCharacter.h"
+#include "ParkourMovementComponent.h"
+#include "Ladder.h"
+#include "Zipline.h"
+#include "Components/BoxComponent.h"
+#include "Components/CapsuleComponent.h"
+#include "Engine/CollisionProfile.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+
+/**
+ * Functional tests for the parkour movement modes. Each test builds a small course out of box colliders in an empty game world, drives a
+ * single AI controlled AParkourFPSCharacter through the same entry points the input bindings use and checks the mode transitions and
+ * where the character ends up. Run with "Automation RunTests ParkourFPS.Movement".
+ *
+ * Every test also checks the per tick scene query budget of each mode it visited. Tick times depend on the machine running the tests,
+ * going over the time budget is only reported as a warning.
+ */
+class FParkourMovementTestWorld
+{
+public:
+	FParkourMovementTestWorld()
+	{
+		World = UParkourBenchmarkCommandlet::CreateBenchmarkWorld(TEXT("ParkourMovementTests"));
+
+		// Floor with its top at Z = 0
+		SpawnBlock(FVector(0.f, 0.f, -50.f), FVector(5000.f, 5000.f, 50.f));
+	}
+
+	~FParkourMovementTestWorld()
+	{
+		UParkourBenchmarkCommandlet::UnloadBenchmarkWorld(World);
+	}
+
+	AActor* SpawnBlock(const FVector& Center, const FVector& Extent)
+	{
+		AActor* Block = World->SpawnActor<AActor>(AActor::StaticClass(), FTransform(Center));
+
+		UBoxComponent* Box = NewObject<UBoxComponent>(Block);
+		Box->SetBoxExtent(Extent);
+		Box->SetCollisionProfileName(UCollisionProfile::BlockAll_ProfileName);
+		Block->SetRootComponent(Box);
+		Box->RegisterComponent();
+		Block->SetActorLocation(Center);
+
+		return Block;
+	}
+
+	AZipline* SpawnZipline(const FVector& Start, const FVector& End)
+	{
+		const FVector Center = (Start + End) / 2.f;
+		AZipline* Zipline = World->SpawnActor<AZipline>(AZipline::StaticClass(), FTransform((End - Start).Rotation(), Center));
+
+		Zipline->CollisionBox->SetBoxExtent(FVector((End - Start).Size() / 2.f, 10.f, 10.f));
+		Zipline->CollisionBox->SetCollisionProfileName(UCollisionProfile::BlockAll_ProfileName);
+
+		// BeginPlay takes the actor location as the start point
+		Zipline->StartPoint = Start;
+		Zipline->EndPoint = End;
+
+		return Zipline;
+	}
+
+	ALadder* SpawnLadder(const FVector& Center, const FVector& Extent)
+	{
+		ALadder* Ladder = World->SpawnActor<ALadder>(ALadder::StaticClass(), FTransform(Center));
+
+		Ladder->CollisionBox->SetBoxExtent(Extent);
+		Ladder->CollisionBox->SetCollisionProfileName(UCollisionProfile::BlockAll_ProfileName);
+
+		Ladder->TopPoint = Center + FVector(0.f, 0.f, Extent.Z);
+		Ladder->BottomPoint = Center - FVector(0.f, 0.f, Extent.Z);
+
+		return Ladder;
+	}
+
+	AParkourFPSCharacter* SpawnCharacter(const FVector& Location, const FRotator& Rotation)
+	{
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+		Character = World->SpawnActor<AParkourFPSCharacter>(AParkourFPSCharacter::StaticClass(), FTransform(Rotation, Location), SpawnParams);
+		Character->SpawnDefaultController();
+
+		Movement = Character->GetParkourMovementComponent();
+
+		return Character;
+	}
+
+	// Ticks the world once, adding MoveInput to the character first like a held movement key would
+	void Tick()
+	{
+		if (!MoveInput.IsZero())
+		{
+			Character->AddMovementInput(MoveInput);
+		}
+
+		World->Tick(LEVELTICK_All, UParkourBenchmarkCommandlet::TickDeltaTime);
+	}
+
+	// Ticks until Condition is true, returns false if it still isn't after MaxTicks
+	bool TickUntil(TFunctionRef<bool()> Condition, int32 MaxTicks)
+	{
+		for (int32 i = 0; i < MaxTicks; i++)
+		{
+			Tick();
+
+			if (Condition())
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	bool IsInMode(ECustomMovementMode Mode) const
+	{
+		return Movement->IsCustomMovementMode(Mode);
+	}
+
+	// Checked against the ParkourBenchmark commandlet's default budget
+	void CheckBudgets(FAutomationTestBase& Test) const
+	{
+		const UParkourBenchmarkCommandlet::FMoveBudget Budget;
+		const TArray<FParkourModeTickCost>& ModeTickCosts = Movement->GetModeTickCosts();
+		const UEnum* CustomModeEnum = StaticEnum<ECustomMovementMode>();
+
+		for (int32 i = 0; i < ModeTickCosts.Num(); i++)
+		{
+			if (ModeTickCosts[i].Ticks == 0)
+			{
+				continue;
+			}
+
+			const FString ModeName = i < CMOVE_MAX ? CustomModeEnum->GetNameStringByValue(i) : TEXT("None");
+			const double MsPerTick = FPlatformTime::ToMilliseconds64(ModeTickCosts[i].Cycles) / ModeTickCosts[i].Ticks;
+
+			Test.TestTrue(FString::Printf(TEXT("%s stays within %d scene queries per tick (%d)"), *ModeName, Budget.MaxSceneQueries, ModeTickCosts[i].MaxSceneQueries),
+				ModeTickCosts[i].MaxSceneQueries <= Budget.MaxSceneQueries);
+
+			if (MsPerTick > Budget.MaxMsPerTick)
+			{
+				Test.AddWarning(FString::Printf(TEXT("%s over time budget: %.4f ms/tick (budget %.4f)"), *ModeName, MsPerTick, Budget.MaxMsPerTick));
+			}
+		}
+	}
+
+	// Tuning values are blueprint configured in the game, the native defaults are too slow for some of the moves to finish
+	void SetVerticalWallRunStartSpeed(float Speed)
+	{
+		Movement->VerticalWallRunStartSpeed = Speed;
+	}
+
+	// Called by the climb montage's notify in the game
+	void EndClimbLedge()
+	{
+		Movement->EndClimbLedge();
+	}
+
+	bool IsClimbingLedge() const
+	{
+		return Movement->IsClimbingLedge;
+	}
+
+	bool IsSliding() const
+	{
+		return Movement->IsSliding;
+	}
+
+	UWorld* World = nullptr;
+	AParkourFPSCharacter* Character = nullptr;
+	UParkourMovementComponent* Movement = nullptr;
+
+	FVector MoveInput = FVector::ZeroVector;
+};
+
+namespace ParkourMovementTests
+{
+	// Wall along +X on the character's right, tall enough that the upwards push at the start of a wall run can't carry it over the top
+	const FVector WallRunWallCenter(500.f, 150.f, 500.f);
+	const FVector WallRunWallExtent(600.f, 50.f, 500.f);
+
+	// Wall in front of the character with its top in ledge hang reach of a vertical wall run
+	const FVector LedgeWallCenter(300.f, 0.f, 150.f);
+	const FVector LedgeWallExtent(100.f, 500.f, 150.f);
+
+	// Walks forwards from standing and starts a slide once the character is moving
+	bool WalkIntoSlide(FAutomationTestBase& Test, FParkourMovementTestWorld& TestWorld)
+	{
+		TestWorld.MoveInput = FVector::ForwardVector;
+
+		for (int32 i = 0; i < 10; i++)
+		{
+			TestWorld.Tick();
+		}
+
+		TestWorld.Movement->SetMovementKey2Down(true);
+
+		const bool StartedSlide = TestWorld.TickUntil([&TestWorld]() { return TestWorld.IsInMode(CMOVE_Sliding); }, 10);
+
+		// Movement input is ignored during a slide
+		TestWorld.MoveInput = FVector::ZeroVector;
+
+		return Test.TestTrue(TEXT("Walking forwards with the slide key down starts a slide"), StartedSlide);
+	}
+
+	// Runs up the ledge wall from standing until the ledge hang begins
+	bool VerticalWallRunToLedgeHang(FAutomationTestBase& Test, FParkourMovementTestWorld& TestWorld)
+	{
+		TestWorld.SpawnBlock(LedgeWallCenter, LedgeWallExtent);
+		TestWorld.SpawnCharacter(FVector(140.f, 0.f, 100.f), FRotator::ZeroRotator);
+		TestWorld.SetVerticalWallRunStartSpeed(800.f);
+
+		TestWorld.Movement->SetMovementKey3Down(true);
+		TestWorld.MoveInput = FVector::ForwardVector;
+
+		const bool StartedVerticalWallRun = TestWorld.TickUntil([&TestWorld]() { return TestWorld.IsInMode(CMOVE_VerticalWallRunning); }, 60);
+
+		if (!Test.TestTrue(TEXT("Walking into the wall with the vertical wall run key down starts a vertical wall run"), StartedVerticalWallRun))
+		{
+			return false;
+		}
+
+		TestWorld.MoveInput = FVector::ZeroVector;
+
+		const float StartZ = TestWorld.Character->GetActorLocation().Z;
+		const bool StartedLedgeHang = TestWorld.TickUntil([&TestWorld]() { return TestWorld.IsInMode(CMOVE_LedgeHang); }, 120);
+
+		if (!Test.TestTrue(TEXT("The vertical wall run turns into a ledge hang at the top of the wall"), StartedLedgeHang))
+		{
+			return false;
+		}
+
+		const float LedgeZ = LedgeWallCenter.Z + LedgeWallExtent.Z;
+		const float HalfHeight = TestWorld.Character->GetCapsuleComponent()->GetScaledCapsuleHalfHeight();
+		const FVector HangLocation = TestWorld.Character->GetActorLocation();
+
+		Test.TestTrue(TEXT("The character climbed during the vertical wall run"), HangLocation.Z > StartZ);
+		Test.TestTrue(TEXT("The character hangs with its head above the ledge"), HangLocation.Z + HalfHeight > LedgeZ);
+		Test.TestTrue(TEXT("The character hangs with its feet below the ledge"), HangLocation.Z - HalfHeight < LedgeZ);
+		Test.TestTrue(TEXT("The character hangs against the wall"), HangLocation.X < LedgeWallCenter.X - LedgeWallExtent.X);
+
+		// The hang settles within a few ticks and then holds still
+		for (int32 i = 0; i < 30; i++)
+		{
+			TestWorld.Tick();
+		}
+
+		const FVector SettledLocation = TestWorld.Character->GetActorLocation();
+		TestWorld.Tick();
+
+		Test.TestTrue(TEXT("The ledge hang holds once settled"), TestWorld.IsInMode(CMOVE_LedgeHang));
+		Test.TestEqual(TEXT("The character doesn't move while hanging"), TestWorld.Character->GetActorLocation(), SettledLocation, 0.1f);
+
+		return true;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FParkourWallRunTest, "ParkourFPS.Movement.WallRun",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FParkourWallRunTest::RunTest(const FString& Parameters)
+{
+	using namespace ParkourMovementTests;
+
+	FParkourMovementTestWorld TestWorld;
+	TestWorld.SpawnBlock(WallRunWallCenter, WallRunWallExtent);
+
+	AParkourFPSCharacter* Character = TestWorld.SpawnCharacter(FVector(0.f, 40.f, 150.f), FRotator::ZeroRotator);
+	TestWorld.Movement->SetMovementKey1Down(true);
+
+	// Jump forwards and towards the wall, the hit runs CheckCanWallRun
+	Character->LaunchCharacter(FVector(500.f, 150.f, 400.f), true, true);
+
+	const bool StartedWallRun = TestWorld.TickUntil([&TestWorld]() { return TestWorld.IsInMode(CMOVE_WallRunning); }, 60);
+
+	if (!TestTrue(TEXT("Jumping into the wall with the wall run key down starts a wall run"), StartedWallRun))
+	{
+		return false;
+	}
+
+	const float WallFaceY = WallRunWallCenter.Y - WallRunWallExtent.Y;
+	const FVector StartLocation = Character->GetActorLocation();
+
+	TestTrue(TEXT("The wall run starts next to the wall"), StartLocation.Y < WallFaceY && StartLocation.Y > WallFaceY - 100.f);
+
+	for (int32 i = 0; i < 20; i++)
+	{
+		TestWorld.Tick();
+	}
+
+	const FVector RunningLocation = Character->GetActorLocation();
+
+	TestTrue(TEXT("The wall run holds while next to the wall"), TestWorld.IsInMode(CMOVE_WallRunning));
+	TestTrue(TEXT("The wall run moves along the wall"), RunningLocation.X > StartLocation.X + 100.f);
+	TestEqual(TEXT("The wall run keeps to the wall"), RunningLocation.Y, StartLocation.Y, 5.f);
+
+	// Runs off the end of the wall
+	const bool EndedWallRun = TestWorld.TickUntil([&TestWorld]() { return !TestWorld.IsInMode(CMOVE_WallRunning); }, 180);
+
+	if (!TestTrue(TEXT("The wall run ends"), EndedWallRun))
+	{
+		return false;
+	}
+
+	const float WallEndX = WallRunWallCenter.X + WallRunWallExtent.X;
+
+	TestTrue(TEXT("The wall run ends at the end of the wall"), Character->GetActorLocation().X > WallEndX - 100.f);
+	TestTrue(TEXT("The character falls after the wall run"), TestWorld.Movement->MovementMode == MOVE_Falling);
+
+	const bool Landed = TestWorld.TickUntil([&TestWorld]() { return TestWorld.Movement->IsMovingOnGround(); }, 240);
+
+	TestTrue(TEXT("The character lands after the wall run"), Landed);
+
+	TestWorld.CheckBudgets(*this);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FParkourWallRunRequiresKeyTest, "ParkourFPS.Movement.WallRunRequiresKey",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FParkourWallRunRequiresKeyTest::RunTest(const FString& Parameters)
+{
+	using namespace ParkourMovementTests;
+
+	FParkourMovementTestWorld TestWorld;
+	TestWorld.SpawnBlock(WallRunWallCenter, WallRunWallExtent);
+
+	AParkourFPSCharacter* Character = TestWorld.SpawnCharacter(FVector(0.f, 40.f, 150.f), FRotator::ZeroRotator);
+	Character->LaunchCharacter(FVector(500.f, 150.f, 400.f), true, true);
+
+	const bool StartedWallRun = TestWorld.TickUntil([&TestWorld]() { return TestWorld.IsInMode(CMOVE_WallRunning); }, 90);
+
+	TestFalse(TEXT("Hitting the wall without the wall run key down doesn't start a wall run"), StartedWallRun);
+
+	TestWorld.CheckBudgets(*this);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FParkourVerticalWallRunLedgeHangTest, "ParkourFPS.Movement.VerticalWallRunLedgeHang",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FParkourVerticalWallRunLedgeHangTest::RunTest(const FString& Parameters)
+{
+	FParkourMovementTestWorld TestWorld;
+
+	if (ParkourMovementTests::VerticalWallRunToLedgeHang(*this, TestWorld))
+	{
+		TestWorld.CheckBudgets(*this);
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FParkourLedgeClimbTest, "ParkourFPS.Movement.LedgeClimb",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FParkourLedgeClimbTest::RunTest(const FString& Parameters)
+{
+	FParkourMovementTestWorld TestWorld;
+
+	if (!ParkourMovementTests::VerticalWallRunToLedgeHang(*this, TestWorld))
+	{
+		return true;
+	}
+
+	const FVector HangLocation = TestWorld.Character->GetActorLocation();
+
+	TestWorld.Movement->SetWantsToClimbLedge(true);
+	TestWorld.Tick();
+	TestWorld.Movement->SetWantsToClimbLedge(false);
+
+	TestFalse(TEXT("Climbing ends the ledge hang"), TestWorld.IsInMode(CMOVE_LedgeHang));
+	TestTrue(TEXT("The climb begins"), TestWorld.IsClimbingLedge());
+	TestTrue(TEXT("The climb is flying until the climb montage ends"), TestWorld.Movement->MovementMode == MOVE_Flying);
+	TestTrue(TEXT("The climb lifts the character over the ledge"), TestWorld.Character->GetActorLocation().Z >= HangLocation.Z + 59.f);
+
+	TestWorld.EndClimbLedge();
+	TestWorld.Tick();
+
+	TestFalse(TEXT("The climb ends when the climb montage ends"), TestWorld.IsClimbingLedge());
+	TestTrue(TEXT("The character stops flying after the climb"), TestWorld.Movement->MovementMode != MOVE_Flying);
+
+	TestWorld.CheckBudgets(*this);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FParkourZiplineTest, "ParkourFPS.Movement.Zipline",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FParkourZiplineTest::RunTest(const FString& Parameters)
+{
+	FParkourMovementTestWorld TestWorld;
+
+	const FVector ZiplineStart(0.f, 0.f, 400.f);
+	const FVector ZiplineEnd(1000.f, 0.f, 400.f);
+	TestWorld.SpawnZipline(ZiplineStart, ZiplineEnd);
+
+	// Jump up into the zipline from below it
+	AParkourFPSCharacter* Character = TestWorld.SpawnCharacter(FVector(100.f, 0.f, 100.f), FRotator::ZeroRotator);
+	Character->LaunchCharacter(FVector(0.f, 0.f, 700.f), true, true);
+
+	const bool StartedZipline = TestWorld.TickUntil([&TestWorld]() { return TestWorld.IsInMode(CMOVE_Ziplining); }, 60);
+
+	if (!TestTrue(TEXT("Jumping into the zipline starts ziplining"), StartedZipline))
+	{
+		return false;
+	}
+
+	const FVector StartLocation = Character->GetActorLocation();
+
+	for (int32 i = 0; i < 20; i++)
+	{
+		TestWorld.Tick();
+	}
+
+	const FVector RidingLocation = Character->GetActorLocation();
+
+	TestTrue(TEXT("The zipline holds while riding"), TestWorld.IsInMode(CMOVE_Ziplining));
+	TestTrue(TEXT("The zipline moves the character towards its end point"), RidingLocation.X > StartLocation.X + 100.f);
+	TestEqual(TEXT("The zipline doesn't move the character off the line"), RidingLocation.Y, StartLocation.Y, 1.f);
+	TestEqual(TEXT("The zipline doesn't drop the character"), RidingLocation.Z, StartLocation.Z, 1.f);
+
+	const bool EndedZipline = TestWorld.TickUntil([&TestWorld]() { return !TestWorld.IsInMode(CMOVE_Ziplining); }, 240);
+
+	if (!TestTrue(TEXT("The zipline ends"), EndedZipline))
+	{
+		return false;
+	}
+
+	TestTrue(TEXT("The zipline ends near its end point"), Character->GetActorLocation().X > ZiplineEnd.X - 200.f);
+	TestTrue(TEXT("The character falls off the end of the zipline"), TestWorld.Movement->MovementMode == MOVE_Falling);
+
+	TestWorld.CheckBudgets(*this);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FParkourLadderTest, "ParkourFPS.Movement.Ladder",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FParkourLadderTest::RunTest(const FString& Parameters)
+{
+	FParkourMovementTestWorld TestWorld;
+
+	const FVector LadderCenter(300.f, 0.f, 150.f);
+	const FVector LadderExtent(20.f, 60.f, 150.f);
+	ALadder* Ladder = TestWorld.SpawnLadder(LadderCenter, LadderExtent);
+
+	AParkourFPSCharacter* Character = TestWorld.SpawnCharacter(FVector(150.f, 0.f, 100.f), FRotator::ZeroRotator);
+	const float HalfHeight = Character->GetCapsuleComponent()->GetScaledCapsuleHalfHeight();
+
+	// Walk into the ladder
+	TestWorld.MoveInput = FVector::ForwardVector;
+
+	const bool StartedClimb = TestWorld.TickUntil([&TestWorld]() { return TestWorld.IsInMode(CMOVE_ClimbLadder); }, 90);
+
+	if (!TestTrue(TEXT("Walking into the ladder starts climbing it"), StartedClimb))
+	{
+		return false;
+	}
+
+	TestWorld.MoveInput = FVector::ZeroVector;
+
+	// Climb part of the way up
+	const FVector StartLocation = Character->GetActorLocation();
+	TestWorld.Movement->SetWantsToGoUpLadder(true);
+
+	for (int32 i = 0; i < 10; i++)
+	{
+		TestWorld.Tick();
+	}
+
+	const FVector ClimbingLocation = Character->GetActorLocation();
+
+	TestTrue(TEXT("The ladder holds while climbing up"), TestWorld.IsInMode(CMOVE_ClimbLadder));
+	TestTrue(TEXT("Climbing up the ladder raises the character"), ClimbingLocation.Z > StartLocation.Z + 50.f);
+	TestEqual(TEXT("Climbing the ladder doesn't move the character off it"), ClimbingLocation.X, StartLocation.X, 1.f);
+
+	// Climb back down to the floor
+	TestWorld.Movement->SetWantsToGoUpLadder(false);
+	TestWorld.Movement->SetWantsToGoDownLadder(true);
+
+	const bool ReachedBottom = TestWorld.TickUntil([&TestWorld]() { return !TestWorld.IsInMode(CMOVE_ClimbLadder); }, 120);
+
+	TestWorld.Movement->SetWantsToGoDownLadder(false);
+
+	if (!TestTrue(TEXT("Climbing down the ladder ends the climb at the floor"), ReachedBottom))
+	{
+		return false;
+	}
+
+	TestTrue(TEXT("Climbing down the ladder lowers the character"), Character->GetActorLocation().Z < ClimbingLocation.Z);
+	TestTrue(TEXT("The climb down ends on the floor"), Character->GetActorLocation().Z - HalfHeight < 5.f);
+
+	// Walk into the ladder again and climb all the way up
+	TestWorld.MoveInput = FVector::ForwardVector;
+
+	const bool StartedSecondClimb = TestWorld.TickUntil([&TestWorld]() { return TestWorld.IsInMode(CMOVE_ClimbLadder); }, 90);
+
+	if (!TestTrue(TEXT("Walking into the ladder after climbing down starts climbing it again"), StartedSecondClimb))
+	{
+		return false;
+	}
+
+	TestWorld.MoveInput = FVector::ZeroVector;
+	TestWorld.Movement->SetWantsToGoUpLadder(true);
+
+	const bool ReachedTop = TestWorld.TickUntil([&TestWorld]() { return !TestWorld.IsInMode(CMOVE_ClimbLadder); }, 120);
+
+	TestWorld.Movement->SetWantsToGoUpLadder(false);
+
+	if (!TestTrue(TEXT("Climbing up the ladder ends the climb at the top"), ReachedTop))
+	{
+		return false;
+	}
+
+	TestTrue(TEXT("The climb up ends with the character's feet at the top of the ladder"), Character->GetActorLocation().Z - HalfHeight >= Ladder->TopPoint.Z - 1.f);
+
+	TestWorld.CheckBudgets(*this);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FParkourSlideTest, "ParkourFPS.Movement.Slide",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FParkourSlideTest::RunTest(const FString& Parameters)
+{
+	FParkourMovementTestWorld TestWorld;
+
+	AParkourFPSCharacter* Character = TestWorld.SpawnCharacter(FVector(0.f, 0.f, 100.f), FRotator::ZeroRotator);
+
+	if (!ParkourMovementTests::WalkIntoSlide(*this, TestWorld))
+	{
+		return false;
+	}
+
+	const FVector StartLocation = Character->GetActorLocation();
+
+	for (int32 i = 0; i < 10; i++)
+	{
+		TestWorld.Tick();
+	}
+
+	const FVector SlidingLocation = Character->GetActorLocation();
+	const float HalfHeight = Character->GetCapsuleComponent()->GetScaledCapsuleHalfHeight();
+
+	TestTrue(TEXT("The slide holds while fast enough"), TestWorld.IsInMode(CMOVE_Sliding));
+	TestTrue(TEXT("The slide moves the character forwards"), SlidingLocation.X > StartLocation.X + 50.f);
+	TestEqual(TEXT("The slide keeps the character's feet on the floor"), SlidingLocation.Z - HalfHeight, 0.f, 5.f);
+	TestTrue(TEXT("The slide is based on the floor"), TestWorld.Movement->GetMovementBase() != nullptr);
+
+	// Braking slows the slide down until it is walked out of
+	const bool EndedSlide = TestWorld.TickUntil([&TestWorld]() { return !TestWorld.IsInMode(CMOVE_Sliding); }, 120);
+
+	if (!TestTrue(TEXT("The slide ends once it has slowed down"), EndedSlide))
+	{
+		return false;
+	}
+
+	TestFalse(TEXT("Ending the slide clears the slide state"), TestWorld.IsSliding());
+	TestTrue(TEXT("The character walks after the slide"), TestWorld.Movement->MovementMode == MOVE_Walking);
+
+	TestWorld.CheckBudgets(*this);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FParkourSlideOffLedgeTest, "ParkourFPS.Movement.SlideOffLedge",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FParkourSlideOffLedgeTest::RunTest(const FString& Parameters)
+{
+	FParkourMovementTestWorld TestWorld;
+
+	// Platform with its top at Z = 200 and its edge at X = 300, far higher than a step
+	const FVector PlatformCenter(0.f, 0.f, 100.f);
+	const FVector PlatformExtent(300.f, 300.f, 100.f);
+	TestWorld.SpawnBlock(PlatformCenter, PlatformExtent);
+
+	AParkourFPSCharacter* Character = TestWorld.SpawnCharacter(FVector(100.f, 0.f, 300.f), FRotator::ZeroRotator);
+
+	if (!ParkourMovementTests::WalkIntoSlide(*this, TestWorld))
+	{
+		return false;
+	}
+
+	const bool LeftSlide = TestWorld.TickUntil([&TestWorld]() { return !TestWorld.IsInMode(CMOVE_Sliding); }, 60);
+
+	if (!TestTrue(TEXT("The slide ends"), LeftSlide))
+	{
+		return false;
+	}
+
+	TestTrue(TEXT("The slide ends past the edge of the platform"), Character->GetActorLocation().X > PlatformCenter.X + PlatformExtent.X);
+	TestTrue(TEXT("The character falls off the edge instead of sliding on through the air"), TestWorld.Movement->MovementMode == MOVE_Falling);
+	TestFalse(TEXT("Falling off the edge ends the slide"), TestWorld.IsSliding());
+
+	const bool Landed = TestWorld.TickUntil([&TestWorld]() { return TestWorld.Movement->IsMovingOnGround(); }, 240);
+
+	TestTrue(TEXT("The character lands after falling off the platform"), Landed);
+	TestTrue(TEXT("The character lands on the floor below the platform"), Character->GetActorLocation().Z < PlatformCenter.Z + PlatformExtent.Z);
+
+	TestWorld.CheckBudgets(*this);
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,262 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ParkourPerfReportCommandlet.h"
+#include "ParkourLog.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+namespace
+{
+	const TCHAR* ParkourCsvColumnPrefix = TEXT("ParkourMovement/");
+
+	// Stats whose baseline p95 is below this are too small to compare reliably
+	const float RegressionNoiseFloor = 0.01f;
+}
+
+UParkourPerfReportCommandlet::UParkourPerfReportCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+int32 UParkourPerfReportCommandlet::Main(const FString& Params)
+{
+	FString CapturePath;
+
+	if (!FParse::Value(*Params, TEXT("csv="), CapturePath))
+	{
+		UE_LOG(LogParkourMovement, Error, TEXT("Usage: -run=ParkourPerfReport -csv=<capture.csv> [-out=<report.csv>] [-baseline=<report.csv>] [-threshold=<percent>]"));
+		return 2;
+	}
+
+	FString ReportPath = FPaths::GetBaseFilename(CapturePath, false) + TEXT("_ParkourReport.csv");
+	FParse::Value(*Params, TEXT("out="), ReportPath);
+
+	FString BaselinePath;
+	FParse::Value(*Params, TEXT("baseline="), BaselinePath);
+
+	float ThresholdPercent = 10.f;
+	FParse::Value(*Params, TEXT("threshold="), ThresholdPercent);
+
+	TMap<FString, TArray<float>> Columns;
+	int32 DroppedRows = 0;
+
+	if (!ReadCapture(CapturePath, Columns, DroppedRows))
+	{
+		UE_LOG(LogParkourMovement, Error, TEXT("Could not read any %s columns from %s"), ParkourCsvColumnPrefix, *CapturePath);
+		return 2;
+	}
+
+	if (DroppedRows > 0)
+	{
+		UE_LOG(LogParkourMovement, Warning, TEXT("Dropped %d rows of %s whose cell count does not match the header"), DroppedRows, *CapturePath);
+	}
+
+	TMap<FString, FStatSummary> Baseline;
+
+	if (!BaselinePath.IsEmpty() && !ReadReport(BaselinePath, Baseline))
+	{
+		UE_LOG(LogParkourMovement, Error, TEXT("Could not read baseline report %s"), *BaselinePath);
+		return 2;
+	}
+
+	Columns.KeySort(TLess<FString>());
+
+	const FString CharacterTicksColumn = FString(ParkourCsvColumnPrefix) + TEXT("CharacterTicks");
+	const FString MaxColumnPrefix = FString(ParkourCsvColumnPrefix) + TEXT("Max");
+	const TArray<float>* CharacterTicks = Columns.Find(CharacterTicksColumn);
+
+	if (CharacterTicks == nullptr)
+	{
+		UE_LOG(LogParkourMovement, Warning, TEXT("%s has no %s column, only per frame values can be reported"), *CapturePath, *CharacterTicksColumn);
+	}
+
+	FString Report = TEXT("Stat,Samples,Mean,P50,P95,P99,BaselineP95,DeltaPercent") LINE_TERMINATOR;
+	int32 Regressions = 0;
+
+	auto AddSummary = [&](const FString& Key, TArray<float>& Values)
+	{
+		const FStatSummary Summary = Summarise(Values);
+		const FStatSummary* BaselineSummary = Baseline.Find(Key);
+
+		float DeltaPercent = 0.f;
+
+		if (BaselineSummary && BaselineSummary->P95 > RegressionNoiseFloor)
+		{
+			DeltaPercent = (Summary.P95 - BaselineSummary->P95) / BaselineSummary->P95 * 100.f;
+
+			if (DeltaPercent > ThresholdPercent)
+			{
+				UE_LOG(LogParkourMovement, Error, TEXT("Regression in %s: p95 %.3f vs baseline %.3f (%+.1f%%)"), *Key, Summary.P95, BaselineSummary->P95, DeltaPercent);
+				Regressions++;
+			}
+		}
+
+		UE_LOG(LogParkourMovement, Display, TEXT("%-60s p50 %8.4f  p95 %8.4f  p99 %8.4f"), *Key, Summary.P50, Summary.P95, Summary.P99);
+
+		Report += FString::Printf(TEXT("%s,%d,%.4f,%.4f,%.4f,%.4f,%.4f,%.2f"), *Key, Summary.Samples, Summary.Mean, Summary.P50, Summary.P95, Summary.P99,
+			BaselineSummary ? BaselineSummary->P95 : 0.f, DeltaPercent);
+		Report += LINE_TERMINATOR;
+	};
+
+	for (TPair<FString, TArray<float>>& Column : Columns)
+	{
+		// The Max columns already hold the worst single character tick of each frame
+		if (Column.Key.StartsWith(MaxColumnPrefix))
+		{
+			AddSummary(Column.Key + TEXT("/WorstCharacterTick"), Column.Value);
+			continue;
+		}
+
+		// The other columns are accumulated over every character ticked in a frame. Split each frame's value evenly over its character
+		// ticks and count it once per tick, so the percentiles are over character ticks rather than frames.
+		if (CharacterTicks && Column.Key != CharacterTicksColumn)
+		{
+			TArray<float> PerTickValues;
+
+			for (int32 Frame = 0; Frame < Column.Value.Num(); Frame++)
+			{
+				const int32 Ticks = FMath::RoundToInt((*CharacterTicks)[Frame]);
+
+				for (int32 Tick = 0; Tick < Ticks; Tick++)
+				{
+					PerTickValues.Add(Column.Value[Frame] / Ticks);
+				}
+			}
+
+			AddSummary(Column.Key + TEXT("/PerCharacterTick"), PerTickValues);
+		}
+
+		AddSummary(Column.Key + TEXT("/PerFrame"), Column.Value);
+	}
+
+	if (!FFileHelper::SaveStringToFile(Report, *ReportPath))
+	{
+		UE_LOG(LogParkourMovement, Error, TEXT("Failed to write report to %s"), *ReportPath);
+		return 2;
+	}
+
+	UE_LOG(LogParkourMovement, Display, TEXT("Wrote parkour movement report to %s"), *ReportPath);
+
+	return Regressions > 0 ? 1 : 0;
+}
+
+bool UParkourPerfReportCommandlet::ReadCapture(const FString& Filename, TMap<FString, TArray<float>>& OutColumns, int32& OutDroppedRows)
+{
+	TArray<FString> Lines;
+
+	if (!FFileHelper::LoadFileToStringArray(Lines, *Filename) || Lines.Num() < 2)
+	{
+		return false;
+	}
+
+	TArray<FString> Header;
+	Lines[0].ParseIntoArray(Header, TEXT(","), false);
+
+	TArray<int32> ColumnIndices;
+	OutDroppedRows = 0;
+
+	for (int32 i = 0; i < Header.Num(); i++)
+	{
+		if (Header[i].StartsWith(ParkourCsvColumnPrefix))
+		{
+			ColumnIndices.Add(i);
+			OutColumns.Add(Header[i]);
+		}
+	}
+
+	TArray<FString> Cells;
+
+	for (int32 LineIndex = 1; LineIndex < Lines.Num(); LineIndex++)
+	{
+		// csvprofile captures end with a repeated header row and a metadata row
+		if (Lines[LineIndex].StartsWith(TEXT("[")) || Lines[LineIndex] == Lines[0])
+		{
+			break;
+		}
+
+		Lines[LineIndex].ParseIntoArray(Cells, TEXT(","), false);
+
+		if (Cells.Num() != Header.Num())
+		{
+			OutDroppedRows++;
+			continue;
+		}
+
+		for (int32 ColumnIndex : ColumnIndices)
+		{
+			OutColumns[Header[ColumnIndex]].Add(FCString::Atof(*Cells[ColumnIndex]));
+		}
+	}
+
+	return ColumnIndices.Num() > 0;
+}
+
+bool UParkourPerfReportCommandlet::ReadReport(const FString& Filename, TMap<FString, FStatSummary>& OutSummaries)
+{
+	TArray<FString> Lines;
+
+	if (!FFileHelper::LoadFileToStringArray(Lines, *Filename))
+	{
+		return false;
+	}
+
+	TArray<FString> Cells;
+
+	for (int32 LineIndex = 1; LineIndex < Lines.Num(); LineIndex++)
+	{
+		Lines[LineIndex].ParseIntoArray(Cells, TEXT(","), false);
+
+		if (Cells.Num() < 6)
+		{
+			continue;
+		}
+
+		FStatSummary& Summary = OutSummaries.Add(Cells[0]);
+		Summary.Samples = FCString::Atoi(*Cells[1]);
+		Summary.Mean = FCString::Atof(*Cells[2]);
+		Summary.P50 = FCString::Atof(*Cells[3]);
+		Summary.P95 = FCString::Atof(*Cells[4]);
+		Summary.P99 = FCString::Atof(*Cells[5]);
+	}
+
+	return true;
+}
+
+UParkourPerfReportCommandlet::FStatSummary UParkourPerfReportCommandlet::Summarise(TArray<float>& Values)
+{
+	FStatSummary Summary;
+	Summary.Samples = Values.Num();
+
+	if (Values.Num() == 0)
+	{
+		return Summary;
+	}
+
+	Values.Sort();
+
+	double Sum = 0.0;
+
+	for (float Value : Values)
+	{
+		Sum += Value;
+	}
+
+	Summary.Mean = Sum / Values.Num();
+	Summary.P50 = Percentile(Values, 50.f);
+	Summary.P95 = Percentile(Values, 95.f);
+	Summary.P99 = Percentile(Values, 99.f);
+
+	return Summary;
+}
+
+// nearest rank percentile
+float UParkourPerfReportCommandlet::Percentile(const TArray<float>& SortedValues, float Percent)
+{
+	const int32 Rank = FMath::CeilToInt(Percent / 100.f * SortedValues.Num());
+
+	return SortedValues[FMath::Clamp(Rank - 1, 0, SortedValues.Num() - 1)];
+}
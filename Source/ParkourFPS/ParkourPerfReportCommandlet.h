@@ -0,0 +1,48 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "ParkourPerfReportCommandlet.generated.h"
+
+/**
+ * Summarises the ParkourMovement columns of a csvprofile capture into p50/p95/p99 per stat and compares them against a baseline report.
+ * Accumulated stats are reported per character tick, using the CharacterTicks column, and per frame. The Max columns are reported as the
+ * worst character tick of each frame.
+ *
+ * UE4Editor-Cmd ParkourFPS -run=ParkourPerfReport -csv=<capture.csv> [-out=<report.csv>] [-baseline=<report.csv>] [-threshold=<percent>]
+ *
+ * Returns 1 if any stat's p95 exceeds the baseline by more than the threshold (10% by default), so it can gate a release.
+ */
+UCLASS()
+class PARKOURFPS_API UParkourPerfReportCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UParkourPerfReportCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+
+private:
+	struct FStatSummary
+	{
+		int32 Samples = 0;
+		float Mean = 0.f;
+		float P50 = 0.f;
+		float P95 = 0.f;
+		float P99 = 0.f;
+	};
+
+	// Reads every column of the capture whose name starts with the ParkourMovement category. Rows whose cell count does not match the
+	// header are skipped and counted in OutDroppedRows.
+	static bool ReadCapture(const FString& Filename, TMap<FString, TArray<float>>& OutColumns, int32& OutDroppedRows);
+
+	// Reads a report previously written by this commandlet
+	static bool ReadReport(const FString& Filename, TMap<FString, FStatSummary>& OutSummaries);
+
+	static FStatSummary Summarise(TArray<float>& Values);
+
+	static float Percentile(const TArray<float>& SortedValues, float Percent);
+};
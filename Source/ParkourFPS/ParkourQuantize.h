@@ -0,0 +1,78 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Compact encodings for parkour state sent over the network
+namespace ParkourQuantize
+{
+	inline float SignNotZero(float Value)
+	{
+		return Value >= 0.f ? 1.f : -1.f;
+	}
+
+	// Octahedral encoding of a unit vector in 16 bits, 8 per axis. Worst case error is well under a degree.
+	inline uint16 PackNormal16(const FVector& Normal)
+	{
+		const float L1Norm = FMath::Abs(Normal.X) + FMath::Abs(Normal.Y) + FMath::Abs(Normal.Z);
+
+		if (L1Norm <= SMALL_NUMBER)
+		{
+			return 0;
+		}
+
+		float U = Normal.X / L1Norm;
+		float V = Normal.Y / L1Norm;
+
+		// Fold the lower hemisphere over the diagonals
+		if (Normal.Z < 0.f)
+		{
+			const float FoldedU = (1.f - FMath::Abs(V)) * SignNotZero(U);
+			V = (1.f - FMath::Abs(U)) * SignNotZero(V);
+			U = FoldedU;
+		}
+
+		const uint16 QuantizedU = FMath::Clamp(FMath::RoundToInt((U * 0.5f + 0.5f) * 255.f), 0, 255);
+		const uint16 QuantizedV = FMath::Clamp(FMath::RoundToInt((V * 0.5f + 0.5f) * 255.f), 0, 255);
+
+		return (QuantizedU << 8) | QuantizedV;
+	}
+
+	inline FVector UnpackNormal16(uint16 Packed)
+	{
+		const float U = (Packed >> 8) / 255.f * 2.f - 1.f;
+		const float V = (Packed & 0xFF) / 255.f * 2.f - 1.f;
+
+		FVector Normal(U, V, 1.f - FMath::Abs(U) - FMath::Abs(V));
+
+		if (Normal.Z < 0.f)
+		{
+			const float UnfoldedX = (1.f - FMath::Abs(Normal.Y)) * SignNotZero(Normal.X);
+			Normal.Y = (1.f - FMath::Abs(Normal.X)) * SignNotZero(Normal.Y);
+			Normal.X = UnfoldedX;
+		}
+
+		return Normal.GetSafeNormal();
+	}
+
+	// World space height in tenths of a cm, zigzag encoded so small values of either sign stay short
+	inline void SerializeHeight(FArchive& Ar, float& Height)
+	{
+		uint32 ZigZag = 0;
+
+		if (Ar.IsSaving())
+		{
+			const int32 Quantized = FMath::RoundToInt(Height * 10.f);
+			ZigZag = (uint32(Quantized) << 1) ^ uint32(Quantized >> 31);
+		}
+
+		Ar.SerializeIntPacked(ZigZag);
+
+		if (Ar.IsLoading())
+		{
+			const int32 Quantized = int32(ZigZag >> 1) ^ -int32(ZigZag & 1);
+			Height = Quantized / 10.f;
+		}
+	}
+}
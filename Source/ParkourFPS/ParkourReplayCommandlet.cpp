@@ -0,0 +1,227 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ParkourReplayCommandlet.h"
+#include "ParkourBenchmarkCommandlet.h"
+#include "ParkourFPSCharacter.h"
+#include "ParkourMovementComponent.h"
+#include "ParkourMoveRecording.h"
+#include "ParkourLog.h"
+#include "Engine/World.h"
+#include "GameFramework/GameNetworkManager.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+UParkourReplayCommandlet::UParkourReplayCommandlet()
+{
+	IsClient = false;
+	IsServer = true;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+int32 UParkourReplayCommandlet::Main(const FString& Params)
+{
+	FString RecordingPath;
+
+	if (!FParse::Value(*Params, TEXT("recording="), RecordingPath))
+	{
+		UE_LOG(LogParkourMovement, Error, TEXT("Usage: -run=ParkourReplay -recording=<file or directory> [-map=<package>] [-resync=<cm>] [-out=<report.csv>]"));
+		return 2;
+	}
+
+	FString MapOverride;
+	FParse::Value(*Params, TEXT("map="), MapOverride);
+
+	float ResyncDistance = FMath::Sqrt(GetDefault<AGameNetworkManager>()->MAXPOSITIONERRORSQUARED);
+	FParse::Value(*Params, TEXT("resync="), ResyncDistance);
+
+	FString ReportPath = FPaths::ProfilingDir() / TEXT("ParkourReplay") / FString::Printf(TEXT("Replay_%s.csv"), *FDateTime::Now().ToString());
+	FParse::Value(*Params, TEXT("out="), ReportPath);
+
+	TArray<FString> RecordingFiles;
+
+	if (IFileManager::Get().DirectoryExists(*RecordingPath))
+	{
+		IFileManager::Get().FindFiles(RecordingFiles, *(RecordingPath / TEXT("*.pkmv")), true, false);
+
+		for (FString& RecordingFile : RecordingFiles)
+		{
+			RecordingFile = RecordingPath / RecordingFile;
+		}
+
+		RecordingFiles.Sort();
+	}
+	else
+	{
+		RecordingFiles.Add(RecordingPath);
+	}
+
+	const UEnum* CustomModeEnum = StaticEnum<ECustomMovementMode>();
+
+	FString Report = TEXT("Recording,Mode,Moves,MsPerMove,MaxSceneQueries,AvgDivergence,MaxDivergence,Corrections,ModeMismatches") LINE_TERMINATOR;
+	int32 Failures = 0;
+
+	for (const FString& RecordingFile : RecordingFiles)
+	{
+		FParkourMoveRecording Recording;
+
+		if (!Recording.LoadFromFile(RecordingFile))
+		{
+			UE_LOG(LogParkourMovement, Error, TEXT("Could not read move recording %s"), *RecordingFile);
+			Failures++;
+			continue;
+		}
+
+		const FString MapName = MapOverride.IsEmpty() ? Recording.MapName : MapOverride;
+		TArray<FModeReplayStats> Stats;
+
+		if (!ReplayRecording(Recording, MapName, ResyncDistance, Stats))
+		{
+			UE_LOG(LogParkourMovement, Error, TEXT("Could not load map %s to replay %s"), *MapName, *RecordingFile);
+			Failures++;
+			continue;
+		}
+
+		const FString RecordingName = FPaths::GetBaseFilename(RecordingFile);
+		FModeReplayStats Total;
+
+		for (int32 i = 0; i < Stats.Num(); i++)
+		{
+			const FModeReplayStats& ModeStats = Stats[i];
+
+			Total.Moves += ModeStats.Moves;
+			Total.Cycles += ModeStats.Cycles;
+			Total.MaxSceneQueries = FMath::Max(Total.MaxSceneQueries, ModeStats.MaxSceneQueries);
+			Total.DivergenceSum += ModeStats.DivergenceSum;
+			Total.MaxDivergence = FMath::Max(Total.MaxDivergence, ModeStats.MaxDivergence);
+			Total.Corrections += ModeStats.Corrections;
+			Total.ModeMismatches += ModeStats.ModeMismatches;
+
+			if (ModeStats.Moves == 0)
+			{
+				continue;
+			}
+
+			FString ModeName = i < CMOVE_MAX ? CustomModeEnum->GetNameStringByValue(i) : TEXT("None");
+			ModeName.RemoveFromStart(TEXT("CMOVE_"));
+
+			Report += FString::Printf(TEXT("%s,%s,%d,%.5f,%d,%.3f,%.3f,%d,%d"), *RecordingName, *ModeName, ModeStats.Moves,
+				FPlatformTime::ToMilliseconds64(ModeStats.Cycles) / ModeStats.Moves, ModeStats.MaxSceneQueries, ModeStats.DivergenceSum / ModeStats.Moves,
+				ModeStats.MaxDivergence, ModeStats.Corrections, ModeStats.ModeMismatches);
+			Report += LINE_TERMINATOR;
+		}
+
+		const int32 TotalMoves = FMath::Max(Total.Moves, 1);
+
+		Report += FString::Printf(TEXT("%s,All,%d,%.5f,%d,%.3f,%.3f,%d,%d"), *RecordingName, Total.Moves, FPlatformTime::ToMilliseconds64(Total.Cycles) / TotalMoves,
+			Total.MaxSceneQueries, Total.DivergenceSum / TotalMoves, Total.MaxDivergence, Total.Corrections, Total.ModeMismatches);
+		Report += LINE_TERMINATOR;
+
+		UE_LOG(LogParkourMovement, Display, TEXT("%s: %d moves, %.4f ms/move, %d corrections, max divergence %.2f cm"), *RecordingName, Total.Moves,
+			FPlatformTime::ToMilliseconds64(Total.Cycles) / TotalMoves, Total.Corrections, Total.MaxDivergence);
+	}
+
+	if (!FFileHelper::SaveStringToFile(Report, *ReportPath))
+	{
+		UE_LOG(LogParkourMovement, Error, TEXT("Failed to write replay report to %s"), *ReportPath);
+		return 2;
+	}
+
+	UE_LOG(LogParkourMovement, Display, TEXT("Wrote replay report to %s"), *ReportPath);
+
+	return Failures > 0 ? 2 : 0;
+}
+
+bool UParkourReplayCommandlet::ReplayRecording(const FParkourMoveRecording& Recording, const FString& MapName, float ResyncDistance, TArray<FModeReplayStats>& OutStats)
+{
+	UWorld* World = UParkourBenchmarkCommandlet::LoadBenchmarkWorld(MapName);
+
+	if (World == nullptr)
+	{
+		return false;
+	}
+
+	AParkourFPSCharacter* Character = SpawnReplayCharacter(World, Recording);
+
+	if (Character == nullptr)
+	{
+		UParkourBenchmarkCommandlet::UnloadBenchmarkWorld(World);
+		return false;
+	}
+
+	UParkourMovementComponent* ParkourMovement = Character->GetParkourMovementComponent();
+
+	OutStats.SetNum(CMOVE_MAX + 1);
+
+	for (const FParkourRecordedMove& Move : Recording.Moves)
+	{
+		const int32 StatsIndex = (ParkourMovement->MovementMode == MOVE_Custom && ParkourMovement->CustomMovementMode < CMOVE_MAX) ? ParkourMovement->CustomMovementMode : CMOVE_MAX;
+		FModeReplayStats& Stats = OutStats[StatsIndex];
+
+		const uint32 StartCycles = FPlatformTime::Cycles();
+		const int32 SceneQueries = ParkourMovement->ReplayRecordedMove(Move);
+
+		Stats.Cycles += FPlatformTime::Cycles() - StartCycles;
+		Stats.MaxSceneQueries = FMath::Max(Stats.MaxSceneQueries, SceneQueries);
+		Stats.Moves++;
+
+		const float Divergence = FVector::Dist(Character->GetActorLocation(), Move.ServerLocation);
+
+		Stats.DivergenceSum += Divergence;
+		Stats.MaxDivergence = FMath::Max(Stats.MaxDivergence, Divergence);
+
+		if (ParkourMovement->PackNetworkMovementMode() != Move.ServerMovementMode)
+		{
+			Stats.ModeMismatches++;
+		}
+
+		if (Divergence > ResyncDistance)
+		{
+			Stats.Corrections++;
+
+			// The mode is left alone, entering a parkour mode needs the probes that found its wall, ledge or rail
+			Character->SetActorLocation(Move.ServerLocation, false, nullptr, ETeleportType::TeleportPhysics);
+			ParkourMovement->Velocity = Move.GetServerVelocity();
+		}
+
+		// Advance everything else in the world, the character's own tick is disabled so only the recorded moves move it
+		World->Tick(LEVELTICK_All, Move.DeltaTime);
+	}
+
+	Character->Destroy();
+	UParkourBenchmarkCommandlet::UnloadBenchmarkWorld(World);
+
+	return true;
+}
+
+AParkourFPSCharacter* UParkourReplayCommandlet::SpawnReplayCharacter(UWorld* World, const FParkourMoveRecording& Recording)
+{
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	AParkourFPSCharacter* Character = World->SpawnActor<AParkourFPSCharacter>(UParkourBenchmarkCommandlet::GetCharacterClass(World), Recording.StartLocation,
+		Recording.StartRotation, SpawnParams);
+
+	if (Character == nullptr)
+	{
+		return nullptr;
+	}
+
+	Character->SpawnDefaultController();
+
+	UParkourMovementComponent* ParkourMovement = Character->GetParkourMovementComponent();
+	ParkourMovement->SetComponentTickEnabled(false);
+
+	TEnumAsByte<EMovementMode> StartMode;
+	uint8 StartCustomMode;
+	TEnumAsByte<EMovementMode> StartGroundMode;
+	ParkourMovement->UnpackNetworkMovementMode(Recording.StartMovementMode, StartMode, StartCustomMode, StartGroundMode);
+
+	// A recording that starts mid parkour move starts falling, the first moves re-enter the mode through the usual probes
+	ParkourMovement->SetMovementMode(StartMode == MOVE_Custom ? MOVE_Falling : StartMode.GetValue());
+	ParkourMovement->Velocity = Recording.StartVelocity;
+
+	return Character;
+}
@@ -0,0 +1,48 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "ParkourReplayCommandlet.generated.h"
+
+class AParkourFPSCharacter;
+class FParkourMoveRecording;
+
+/**
+ * Re-simulates move streams recorded on a server with p.Parkour.RecordMoves against the map they were recorded on, so real sessions
+ * can be replayed as repeatable benchmarks.
+ *
+ * UE4Editor-Cmd ParkourFPS -run=ParkourReplay -nullrhi -recording=<file or directory> [-map=<package>] [-resync=<cm>] [-out=<report.csv>]
+ *
+ * For every recording and movement mode the report has the cost of the replayed moves and how far the replay diverged from the positions
+ * the server recorded. A replay further than -resync (the server's correction threshold by default) from the recorded position is counted
+ * as a correction and moved back onto the recording, like a client would be.
+ */
+UCLASS()
+class PARKOURFPS_API UParkourReplayCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UParkourReplayCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+
+private:
+	struct FModeReplayStats
+	{
+		int32 Moves = 0;
+		uint64 Cycles = 0;
+		int32 MaxSceneQueries = 0;
+		double DivergenceSum = 0.0;
+		float MaxDivergence = 0.f;
+		int32 Corrections = 0;
+		int32 ModeMismatches = 0;
+	};
+
+	// Returns false if the recording's map could not be loaded
+	static bool ReplayRecording(const FParkourMoveRecording& Recording, const FString& MapName, float ResyncDistance, TArray<FModeReplayStats>& OutStats);
+
+	static AParkourFPSCharacter* SpawnReplayCharacter(UWorld* World, const FParkourMoveRecording& Recording);
+};
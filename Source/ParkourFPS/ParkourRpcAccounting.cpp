@@ -0,0 +1,87 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ParkourRpcAccounting.h"
+#include "ParkourMovementStats.h"
+
+const TCHAR* EParkourRpc::ToString(Type Rpc)
+{
+	switch (Rpc)
+	{
+	case ServerMove:				return TEXT("ServerMove");
+	default:						return TEXT("Unknown");
+	}
+}
+
+void FParkourRpcAccounting::RecordCall(EParkourRpc::Type Rpc, int64 Bits)
+{
+	CurrentWindow[Rpc].Calls++;
+	CurrentWindow[Rpc].Bits += Bits;
+
+	const int32 Bytes = (Bits + 7) / 8;
+
+#if STATS
+	static const FName CallStats[EParkourRpc::Count] =
+	{
+		GET_STATFNAME(STAT_ParkourRpcServerMoveCalls),
+	};
+
+	static const FName ByteStats[EParkourRpc::Count] =
+	{
+		GET_STATFNAME(STAT_ParkourRpcServerMoveBytes),
+	};
+
+	INC_DWORD_STAT_FNAME_BY(CallStats[Rpc], 1);
+	INC_DWORD_STAT_FNAME_BY(ByteStats[Rpc], Bytes);
+#endif
+
+#if CSV_PROFILER
+	static const FName CsvByteStats[EParkourRpc::Count] =
+	{
+		FName(*FString::Printf(TEXT("RPCBytes_%s"), EParkourRpc::ToString(EParkourRpc::ServerMove))),
+	};
+
+	FCsvProfiler::RecordCustomStat(CsvByteStats[Rpc], CSV_CATEGORY_INDEX(ParkourMovement), Bytes, ECsvCustomStatOp::Accumulate);
+#endif
+}
+
+void FParkourRpcAccounting::Tick(float DeltaTime)
+{
+	CurrentWindowTime += DeltaTime;
+
+	if (CurrentWindowTime < 1.f)
+	{
+		return;
+	}
+
+	for (int32 i = 0; i < EParkourRpc::Count; i++)
+	{
+		LastWindow[i] = CurrentWindow[i];
+		CurrentWindow[i] = FRpcCounters();
+	}
+
+	LastWindowTime = CurrentWindowTime;
+	CurrentWindowTime = 0.f;
+}
+
+float FParkourRpcAccounting::GetCallsPerSecond(EParkourRpc::Type Rpc) const
+{
+	return LastWindowTime > 0.f ? LastWindow[Rpc].Calls / LastWindowTime : 0.f;
+}
+
+float FParkourRpcAccounting::GetBytesPerSecond(EParkourRpc::Type Rpc) const
+{
+	return LastWindowTime > 0.f ? LastWindow[Rpc].Bits / 8.f / LastWindowTime : 0.f;
+}
+
+float FParkourRpcAccounting::GetTotalBytesPerSecond() const
+{
+	float Total = 0.f;
+
+	for (int32 i = 0; i < EParkourRpc::Count; i++)
+	{
+		Total += GetBytesPerSecond((EParkourRpc::Type)i);
+	}
+
+	return Total;
+}
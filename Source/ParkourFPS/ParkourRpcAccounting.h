@@ -0,0 +1,46 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Server RPCs sent by the owning client of a parkour character
+namespace EParkourRpc
+{
+	enum Type : uint8
+	{
+		ServerMove,
+		Count
+	};
+
+	const TCHAR* ToString(Type Rpc);
+}
+
+// Calls and bytes per second for each server RPC of one connection. Sizes are the bits each call added to the connection's
+// send buffer, so they include bunch headers but not packet headers.
+class PARKOURFPS_API FParkourRpcAccounting
+{
+public:
+	void RecordCall(EParkourRpc::Type Rpc, int64 Bits);
+
+	// Rolls the per second window over
+	void Tick(float DeltaTime);
+
+	// Rates over the last completed one second window
+	float GetCallsPerSecond(EParkourRpc::Type Rpc) const;
+	float GetBytesPerSecond(EParkourRpc::Type Rpc) const;
+	float GetTotalBytesPerSecond() const;
+
+private:
+	struct FRpcCounters
+	{
+		int32 Calls = 0;
+		int64 Bits = 0;
+	};
+
+	FRpcCounters CurrentWindow[EParkourRpc::Count];
+	FRpcCounters LastWindow[EParkourRpc::Count];
+
+	float CurrentWindowTime = 0.f;
+	float LastWindowTime = 0.f;
+};
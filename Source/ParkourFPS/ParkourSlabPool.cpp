@@ -0,0 +1,64 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ParkourSlabPool.h"
+
+FParkourSlabPool::FParkourSlabPool(SIZE_T InBlockSize, int32 InBlocksPerSlab)
+	: BlockSize(Align(FMath::Max(InBlockSize, sizeof(FFreeBlock)), PLATFORM_CACHE_LINE_SIZE))
+	, BlocksPerSlab(FMath::Max(InBlocksPerSlab, 1))
+{
+}
+
+FParkourSlabPool::~FParkourSlabPool()
+{
+	check(LiveBlocks == 0);
+
+	for (void* Slab : Slabs)
+	{
+		FMemory::Free(Slab);
+	}
+}
+
+void* FParkourSlabPool::Allocate()
+{
+	if (FreeList == nullptr)
+	{
+		AddSlab();
+	}
+
+	FFreeBlock* Block = FreeList;
+	FreeList = Block->Next;
+
+	LiveBlocks++;
+	HighWaterMark = FMath::Max(HighWaterMark, LiveBlocks);
+
+	return Block;
+}
+
+void FParkourSlabPool::Free(void* Block)
+{
+	if (Block == nullptr)
+	{
+		return;
+	}
+
+	FFreeBlock* FreeBlock = static_cast<FFreeBlock*>(Block);
+	FreeBlock->Next = FreeList;
+	FreeList = FreeBlock;
+
+	LiveBlocks--;
+}
+
+void FParkourSlabPool::AddSlab()
+{
+	uint8* Slab = static_cast<uint8*>(FMemory::Malloc(BlockSize * BlocksPerSlab, PLATFORM_CACHE_LINE_SIZE));
+	Slabs.Add(Slab);
+
+	// Link back to front so blocks are handed out in address order
+	for (int32 i = BlocksPerSlab - 1; i >= 0; i--)
+	{
+		FFreeBlock* Block = reinterpret_cast<FFreeBlock*>(Slab + i * BlockSize);
+		Block->Next = FreeList;
+		FreeList = Block;
+	}
+}
@@ -0,0 +1,45 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Fixed size blocks carved out of cache line aligned slabs. Every block starts on its own cache line, freed blocks go on an
+// intrusive free list and slabs are only returned to the general allocator when the pool is destroyed.
+class PARKOURFPS_API FParkourSlabPool
+{
+public:
+	FParkourSlabPool(SIZE_T InBlockSize, int32 InBlocksPerSlab);
+	~FParkourSlabPool();
+
+	FParkourSlabPool(const FParkourSlabPool&) = delete;
+	FParkourSlabPool& operator=(const FParkourSlabPool&) = delete;
+
+	// Returns uninitialised memory for one block, adding a slab if the free list is empty
+	void* Allocate();
+
+	void Free(void* Block);
+
+	bool HasFreeBlock() const { return FreeList != nullptr; }
+
+	int32 GetLiveBlocks() const { return LiveBlocks; }
+	int32 GetHighWaterMark() const { return HighWaterMark; }
+	int32 GetNumSlabs() const { return Slabs.Num(); }
+
+private:
+	struct FFreeBlock
+	{
+		FFreeBlock* Next;
+	};
+
+	void AddSlab();
+
+	SIZE_T BlockSize;
+	int32 BlocksPerSlab;
+
+	TArray<void*> Slabs;
+	FFreeBlock* FreeList = nullptr;
+
+	int32 LiveBlocks = 0;
+	int32 HighWaterMark = 0;
+};
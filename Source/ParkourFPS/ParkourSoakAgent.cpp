@@ -0,0 +1,211 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ParkourSoakAgent.h"
+#include "ParkourCorrectionAnalytics.h"
+#include "ParkourFPSCharacter.h"
+#include "ParkourMovementComponent.h"
+#include "ParkourLog.h"
+#include "Engine/Engine.h"
+#include "Engine/NetDriver.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "Misc/App.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+
+TUniquePtr<FParkourSoakAgent> FParkourSoakAgent::Instance;
+
+void FParkourSoakAgent::StartFromCommandLine()
+{
+	FString ResultsPath;
+
+	if (!FParse::Value(FCommandLine::Get(), TEXT("ParkourSoak="), ResultsPath))
+	{
+		return;
+	}
+
+	float WarmupSeconds = 10.f;
+	FParse::Value(FCommandLine::Get(), TEXT("ParkourSoakWarmup="), WarmupSeconds);
+
+	float DurationSeconds = 60.f;
+	FParse::Value(FCommandLine::Get(), TEXT("ParkourSoakDuration="), DurationSeconds);
+
+	Instance.Reset(new FParkourSoakAgent(ResultsPath, WarmupSeconds, DurationSeconds));
+
+	FString ScriptPath;
+
+	if (FParse::Value(FCommandLine::Get(), TEXT("ParkourSoakScript="), ScriptPath) && !Instance->Script.LoadFromFile(ScriptPath))
+	{
+		UE_LOG(LogParkourMovement, Error, TEXT("Could not read input script %s, using the default course"), *ScriptPath);
+	}
+
+	UE_LOG(LogParkourMovement, Display, TEXT("Soak agent started: %.0f s warmup, %.0f s measured, results to %s"), WarmupSeconds, DurationSeconds, *ResultsPath);
+}
+
+void FParkourSoakAgent::Stop()
+{
+	Instance.Reset();
+}
+
+FParkourSoakAgent::FParkourSoakAgent(const FString& InResultsPath, float InWarmupSeconds, float InDurationSeconds)
+	: Script(FParkourInputScript::MakeDefaultCourse())
+	, ResultsPath(InResultsPath)
+	, WarmupSeconds(InWarmupSeconds)
+	, DurationSeconds(InDurationSeconds)
+{
+	StartTime = FPlatformTime::Seconds();
+	TickerHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FParkourSoakAgent::Tick));
+}
+
+FParkourSoakAgent::~FParkourSoakAgent()
+{
+	FTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+}
+
+bool FParkourSoakAgent::Tick(float DeltaTime)
+{
+	UWorld* World = FindGameWorld();
+
+	if (World == nullptr)
+	{
+		return true;
+	}
+
+	DriveLocalCharacter(World, DeltaTime);
+
+	const double Now = FPlatformTime::Seconds();
+
+	if (!Measuring)
+	{
+		if (Now - StartTime >= WarmupSeconds)
+		{
+			ResetCounters();
+			MeasureStartTime = Now;
+			LastNetSampleTime = Now;
+			Measuring = true;
+		}
+
+		return true;
+	}
+
+	// the frame's work without the sleep that holds the server to its max tick rate
+	const double FrameBusyMs = FMath::Max(FApp::GetDeltaTime() - FApp::GetIdleTime(), 0.0) * 1000.0;
+
+	Frames++;
+	BusyMs += FrameBusyMs;
+	MaxBusyMs = FMath::Max(MaxBusyMs, FrameBusyMs);
+
+	// the net driver updates its byte rates once a second
+	if (Now - LastNetSampleTime >= 1.0)
+	{
+		LastNetSampleTime = Now;
+		SampleNetDriver(World);
+	}
+
+	if (Now - MeasureStartTime >= DurationSeconds)
+	{
+		if (WriteResults(World))
+		{
+			UE_LOG(LogParkourMovement, Display, TEXT("Wrote soak results to %s"), *ResultsPath);
+		}
+		else
+		{
+			UE_LOG(LogParkourMovement, Error, TEXT("Failed to write soak results to %s"), *ResultsPath);
+		}
+
+		FPlatformMisc::RequestExit(false);
+
+		return false;
+	}
+
+	return true;
+}
+
+UWorld* FParkourSoakAgent::FindGameWorld() const
+{
+	if (GEngine == nullptr)
+	{
+		return nullptr;
+	}
+
+	for (const FWorldContext& Context : GEngine->GetWorldContexts())
+	{
+		if (Context.WorldType == EWorldType::Game && Context.World() && Context.World()->GetNetDriver())
+		{
+			return Context.World();
+		}
+	}
+
+	return nullptr;
+}
+
+void FParkourSoakAgent::DriveLocalCharacter(UWorld* World, float DeltaTime)
+{
+	// A dedicated server's first player controller belongs to a remote client, the server only measures
+	if (World->GetNetMode() == NM_DedicatedServer)
+	{
+		return;
+	}
+
+	APlayerController* PlayerController = World->GetFirstPlayerController();
+
+	if (PlayerController == nullptr || !PlayerController->IsLocalController())
+	{
+		return;
+	}
+
+	AParkourFPSCharacter* Character = Cast<AParkourFPSCharacter>(PlayerController->GetPawn());
+
+	if (Character == nullptr)
+	{
+		return;
+	}
+
+	Script.Apply(Character, ScriptTick++, DeltaTime);
+
+	const UParkourMovementComponent* ParkourMovement = Character->GetParkourMovementComponent();
+
+	if (ParkourMovement->MovementMode == MOVE_Custom && ParkourMovement->CustomMovementMode < CMOVE_MAX)
+	{
+		VisitedModes |= 1u << ParkourMovement->CustomMovementMode;
+	}
+}
+
+void FParkourSoakAgent::SampleNetDriver(UWorld* World)
+{
+	const UNetDriver* NetDriver = World->GetNetDriver();
+
+	NetSamples++;
+	InBytesPerSecondSum += NetDriver->InBytesPerSecond;
+	OutBytesPerSecondSum += NetDriver->OutBytesPerSecond;
+}
+
+void FParkourSoakAgent::ResetCounters()
+{
+	Frames = 0;
+	BusyMs = 0.0;
+	MaxBusyMs = 0.0;
+	NetSamples = 0;
+	InBytesPerSecondSum = 0;
+	OutBytesPerSecondSum = 0;
+	VisitedModes = 0;
+
+	FParkourCorrectionAnalytics::Get().Reset();
+}
+
+bool FParkourSoakAgent::WriteResults(UWorld* World) const
+{
+	const double Seconds = FPlatformTime::Seconds() - MeasureStartTime;
+	const int32 Corrections = FParkourCorrectionAnalytics::Get().GetTotalCorrections();
+	const int32 Samples = FMath::Max(NetSamples, 1);
+
+	FString Csv = TEXT("Role,Seconds,Frames,MsPerFrame,MaxMsPerFrame,InBytesPerSecond,OutBytesPerSecond,Corrections,CorrectionsPerMinute,ModesVisited") LINE_TERMINATOR;
+
+	Csv += FString::Printf(TEXT("%s,%.1f,%d,%.4f,%.4f,%.1f,%.1f,%d,%.2f,%d"), World->GetNetMode() == NM_Client ? TEXT("Client") : TEXT("Server"), Seconds, Frames,
+		BusyMs / FMath::Max(Frames, 1), MaxBusyMs, double(InBytesPerSecondSum) / Samples, double(OutBytesPerSecondSum) / Samples, Corrections,
+		Corrections / FMath::Max(Seconds / 60.0, 1.0 / 60.0), FMath::CountBits(VisitedModes));
+	Csv += LINE_TERMINATOR;
+
+	return FFileHelper::SaveStringToFile(Csv, *ResultsPath);
+}
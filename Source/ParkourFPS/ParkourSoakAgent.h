@@ -0,0 +1,65 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "ParkourInputScript.h"
+
+class UWorld;
+
+// Runs inside the dedicated server and headless clients launched by the ParkourSoak commandlet, enabled with -ParkourSoak=<results.csv>.
+// Clients drive their pawn through the parkour course with an FParkourInputScript and count the corrections they receive, the server
+// measures how long its frames take outside of the tick rate sleep, and both sample their net driver's bandwidth. Counters are reset
+// after -ParkourSoakWarmup seconds, then after another -ParkourSoakDuration seconds one summary row is written and the process exits.
+class PARKOURFPS_API FParkourSoakAgent
+{
+public:
+	static void StartFromCommandLine();
+
+	static void Stop();
+
+	~FParkourSoakAgent();
+
+private:
+	FParkourSoakAgent(const FString& InResultsPath, float InWarmupSeconds, float InDurationSeconds);
+
+	bool Tick(float DeltaTime);
+
+	UWorld* FindGameWorld() const;
+
+	void DriveLocalCharacter(UWorld* World, float DeltaTime);
+
+	void SampleNetDriver(UWorld* World);
+
+	void ResetCounters();
+
+	bool WriteResults(UWorld* World) const;
+
+	static TUniquePtr<FParkourSoakAgent> Instance;
+
+	FParkourInputScript Script;
+	int32 ScriptTick = 0;
+
+	FString ResultsPath;
+	float WarmupSeconds;
+	float DurationSeconds;
+
+	double StartTime;
+	double MeasureStartTime = 0.0;
+	double LastNetSampleTime = 0.0;
+	bool Measuring = false;
+
+	// Over the measured window
+	int32 Frames = 0;
+	double BusyMs = 0.0;
+	double MaxBusyMs = 0.0;
+	int32 NetSamples = 0;
+	uint64 InBytesPerSecondSum = 0;
+	uint64 OutBytesPerSecondSum = 0;
+
+	// Bit per ECustomMovementMode the local character has been in, to check the script still covers every mode
+	uint32 VisitedModes = 0;
+
+	FDelegateHandle TickerHandle;
+};
@@ -0,0 +1,404 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ParkourSoakCommandlet.h"
+#include "ParkourLog.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformProcess.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+namespace
+{
+	// Time the dedicated server gets to load the map before the clients connect
+	const float ServerStartupSeconds = 10.f;
+
+	// Extra time the processes get to load, connect and write their results before they are killed
+	const float ProcessTimeoutSeconds = 60.f;
+
+	// Baseline values below this are too small to compare reliably
+	const float RegressionNoiseFloor = 0.01f;
+
+	const TCHAR* const ResultColumns[] =
+	{
+		TEXT("CorrectionsPerMinute"),
+		TEXT("ClientInBytesPerSecond"),
+		TEXT("ClientOutBytesPerSecond"),
+		TEXT("ServerInBytesPerSecond"),
+		TEXT("ServerOutBytesPerSecond"),
+		TEXT("ServerMsPerFrame"),
+		TEXT("ServerMaxMsPerFrame"),
+		TEXT("ModesVisited"),
+	};
+
+	// Columns compared against the baseline, all lower is better
+	const TCHAR* const RegressionColumns[] =
+	{
+		TEXT("CorrectionsPerMinute"),
+		TEXT("ClientOutBytesPerSecond"),
+		TEXT("ServerOutBytesPerSecond"),
+		TEXT("ServerMsPerFrame"),
+	};
+}
+
+UParkourSoakCommandlet::UParkourSoakCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+int32 UParkourSoakCommandlet::Main(const FString& Params)
+{
+	FSoakSettings Settings;
+
+	if (!FParse::Value(*Params, TEXT("map="), Settings.MapName))
+	{
+		UE_LOG(LogParkourMovement, Error, TEXT("Usage: -run=ParkourSoak -map=<package> [-clients=4] [-warmup=10] [-duration=60] [-profiles=<file>] [-script=<file>] [-port=7777] [-exe=<path>] [-out=<results.csv>] [-baseline=<results.csv>] [-threshold=<percent>]"));
+		return 2;
+	}
+
+	Settings.Executable = FPlatformProcess::ExecutablePath();
+	FParse::Value(*Params, TEXT("exe="), Settings.Executable);
+	FParse::Value(*Params, TEXT("script="), Settings.ScriptPath);
+	FParse::Value(*Params, TEXT("clients="), Settings.Clients);
+	FParse::Value(*Params, TEXT("port="), Settings.Port);
+	FParse::Value(*Params, TEXT("warmup="), Settings.WarmupSeconds);
+	FParse::Value(*Params, TEXT("duration="), Settings.DurationSeconds);
+
+	Settings.Clients = FMath::Max(Settings.Clients, 1);
+	Settings.ResultsDir = FPaths::ConvertRelativePathToFull(FPaths::ProfilingDir() / TEXT("ParkourSoak") / FDateTime::Now().ToString());
+
+	IFileManager::Get().MakeDirectory(*Settings.ResultsDir, true);
+
+	FString ResultsPath = Settings.ResultsDir / TEXT("SoakResults.csv");
+	FParse::Value(*Params, TEXT("out="), ResultsPath);
+
+	FString BaselinePath;
+	FParse::Value(*Params, TEXT("baseline="), BaselinePath);
+
+	float ThresholdPercent = 10.f;
+	FParse::Value(*Params, TEXT("threshold="), ThresholdPercent);
+
+	TArray<FNetProfile> Profiles = MakeDefaultProfiles();
+	FString ProfilesPath;
+
+	if (FParse::Value(*Params, TEXT("profiles="), ProfilesPath) && !LoadProfiles(ProfilesPath, Profiles))
+	{
+		UE_LOG(LogParkourMovement, Error, TEXT("Could not read emulation profiles %s"), *ProfilesPath);
+		return 2;
+	}
+
+	TMap<FString, TMap<FString, float>> Baseline;
+
+	if (!BaselinePath.IsEmpty() && !ReadCsvRows(BaselinePath, Baseline))
+	{
+		UE_LOG(LogParkourMovement, Error, TEXT("Could not read baseline results %s"), *BaselinePath);
+		return 2;
+	}
+
+	FString Results = TEXT("Profile,Clients,PktLag,PktLagVariance,PktLoss,PktDup");
+
+	for (const TCHAR* Column : ResultColumns)
+	{
+		Results += TEXT(",");
+		Results += Column;
+	}
+
+	Results += LINE_TERMINATOR;
+
+	int32 Failures = 0;
+	int32 Regressions = 0;
+
+	for (const FNetProfile& Profile : Profiles)
+	{
+		UE_LOG(LogParkourMovement, Display, TEXT("Soaking profile %s: %d clients, lag %d ms +/- %d, loss %d%%, duplication %d%%"), *Profile.Name, Settings.Clients,
+			Profile.PktLag, Profile.PktLagVariance, Profile.PktLoss, Profile.PktDup);
+
+		const TMap<FString, float> Row = RunProfile(Profile, Settings);
+
+		if (Row.Num() == 0)
+		{
+			UE_LOG(LogParkourMovement, Error, TEXT("Profile %s produced no results, see the logs in %s"), *Profile.Name, *Settings.ResultsDir);
+			Failures++;
+			continue;
+		}
+
+		Results += FString::Printf(TEXT("%s,%d,%d,%d,%d,%d"), *Profile.Name, Settings.Clients, Profile.PktLag, Profile.PktLagVariance, Profile.PktLoss, Profile.PktDup);
+
+		for (const TCHAR* Column : ResultColumns)
+		{
+			Results += FString::Printf(TEXT(",%.4f"), Row.FindRef(Column));
+		}
+
+		Results += LINE_TERMINATOR;
+
+		UE_LOG(LogParkourMovement, Display, TEXT("%s: %.2f corrections/min per client, server out %.0f B/s, server %.3f ms/frame, %d modes visited"), *Profile.Name,
+			Row.FindRef(TEXT("CorrectionsPerMinute")), Row.FindRef(TEXT("ServerOutBytesPerSecond")), Row.FindRef(TEXT("ServerMsPerFrame")),
+			FMath::RoundToInt(Row.FindRef(TEXT("ModesVisited"))));
+
+		const TMap<FString, float>* BaselineRow = Baseline.Find(Profile.Name);
+
+		if (BaselineRow == nullptr)
+		{
+			continue;
+		}
+
+		for (const TCHAR* Column : RegressionColumns)
+		{
+			const float BaselineValue = BaselineRow->FindRef(Column);
+			const float Value = Row.FindRef(Column);
+
+			if (BaselineValue > RegressionNoiseFloor && (Value - BaselineValue) / BaselineValue * 100.f > ThresholdPercent)
+			{
+				UE_LOG(LogParkourMovement, Error, TEXT("Regression in %s %s: %.3f vs baseline %.3f"), *Profile.Name, Column, Value, BaselineValue);
+				Regressions++;
+			}
+		}
+	}
+
+	if (!FFileHelper::SaveStringToFile(Results, *ResultsPath))
+	{
+		UE_LOG(LogParkourMovement, Error, TEXT("Failed to write soak results to %s"), *ResultsPath);
+		return 2;
+	}
+
+	UE_LOG(LogParkourMovement, Display, TEXT("Wrote soak results to %s"), *ResultsPath);
+
+	if (Failures > 0)
+	{
+		return 2;
+	}
+
+	return Regressions > 0 ? 1 : 0;
+}
+
+TArray<UParkourSoakCommandlet::FNetProfile> UParkourSoakCommandlet::MakeDefaultProfiles()
+{
+	TArray<FNetProfile> Profiles;
+
+	auto AddProfile = [&Profiles](const TCHAR* Name, int32 PktLag, int32 PktLagVariance, int32 PktLoss, int32 PktDup)
+	{
+		FNetProfile Profile;
+		Profile.Name = Name;
+		Profile.PktLag = PktLag;
+		Profile.PktLagVariance = PktLagVariance;
+		Profile.PktLoss = PktLoss;
+		Profile.PktDup = PktDup;
+
+		Profiles.Add(Profile);
+	};
+
+	// Name, PktLag, PktLagVariance, PktLoss, PktDup
+	AddProfile(TEXT("Clean"), 0, 0, 0, 0);
+	AddProfile(TEXT("Lag150"), 150, 0, 0, 0);
+	AddProfile(TEXT("Jitter"), 100, 40, 0, 0);
+	AddProfile(TEXT("Loss"), 75, 0, 3, 0);
+	AddProfile(TEXT("Duplication"), 75, 0, 0, 3);
+	AddProfile(TEXT("Poor"), 150, 50, 5, 2);
+
+	return Profiles;
+}
+
+bool UParkourSoakCommandlet::LoadProfiles(const FString& Filename, TArray<FNetProfile>& OutProfiles)
+{
+	TArray<FString> Lines;
+
+	if (!FFileHelper::LoadFileToStringArray(Lines, *Filename))
+	{
+		return false;
+	}
+
+	OutProfiles.Reset();
+
+	TArray<FString> Tokens;
+
+	for (FString Line : Lines)
+	{
+		int32 CommentStart;
+
+		if (Line.FindChar(TEXT('#'), CommentStart))
+		{
+			Line.LeftInline(CommentStart);
+		}
+
+		Line.ParseIntoArrayWS(Tokens);
+
+		if (Tokens.Num() < 2)
+		{
+			continue;
+		}
+
+		FNetProfile Profile;
+		Profile.Name = Tokens[0];
+		Profile.PktLag = FCString::Atoi(*Tokens[1]);
+		Profile.PktLagVariance = Tokens.Num() > 2 ? FCString::Atoi(*Tokens[2]) : 0;
+		Profile.PktLoss = Tokens.Num() > 3 ? FCString::Atoi(*Tokens[3]) : 0;
+		Profile.PktDup = Tokens.Num() > 4 ? FCString::Atoi(*Tokens[4]) : 0;
+
+		OutProfiles.Add(Profile);
+	}
+
+	return OutProfiles.Num() > 0;
+}
+
+TMap<FString, float> UParkourSoakCommandlet::RunProfile(const FNetProfile& Profile, const FSoakSettings& Settings)
+{
+	const FString ProjectPath = FPaths::ConvertRelativePathToFull(FPaths::GetProjectFilePath());
+	const FString ServerResultsPath = Settings.ResultsDir / FString::Printf(TEXT("%s_Server.csv"), *Profile.Name);
+
+	// the server measures while the clients do, so its warmup also covers the clients starting up
+	const FString ServerArgs = FString::Printf(TEXT("\"%s\" %s -server -port=%d -abslog=\"%s\" %s"), *ProjectPath, *Settings.MapName, Settings.Port,
+		*(Settings.ResultsDir / FString::Printf(TEXT("%s_Server.log"), *Profile.Name)), *GetAgentArgs(Profile, Settings, ServerResultsPath,
+		ServerStartupSeconds + Settings.WarmupSeconds));
+
+	TArray<FProcHandle> Processes;
+	Processes.Add(FPlatformProcess::CreateProc(*Settings.Executable, *ServerArgs, false, true, true, nullptr, 0, nullptr, nullptr));
+
+	if (!Processes[0].IsValid())
+	{
+		UE_LOG(LogParkourMovement, Error, TEXT("Could not start the dedicated server %s"), *Settings.Executable);
+		return TMap<FString, float>();
+	}
+
+	FPlatformProcess::Sleep(ServerStartupSeconds);
+
+	TArray<FString> ClientResultsPaths;
+
+	for (int32 i = 0; i < Settings.Clients; i++)
+	{
+		const FString ClientResultsPath = Settings.ResultsDir / FString::Printf(TEXT("%s_Client%d.csv"), *Profile.Name, i);
+		const FString ClientArgs = FString::Printf(TEXT("\"%s\" 127.0.0.1:%d -game -nosound -abslog=\"%s\" %s"), *ProjectPath, Settings.Port,
+			*(Settings.ResultsDir / FString::Printf(TEXT("%s_Client%d.log"), *Profile.Name, i)), *GetAgentArgs(Profile, Settings, ClientResultsPath,
+			Settings.WarmupSeconds));
+
+		FProcHandle Client = FPlatformProcess::CreateProc(*Settings.Executable, *ClientArgs, false, true, true, nullptr, 0, nullptr, nullptr);
+
+		if (Client.IsValid())
+		{
+			Processes.Add(Client);
+			ClientResultsPaths.Add(ClientResultsPath);
+		}
+	}
+
+	WaitForProcesses(Processes, Settings.WarmupSeconds + Settings.DurationSeconds + ProcessTimeoutSeconds);
+
+	TMap<FString, TMap<FString, float>> ServerRows;
+
+	if (!ReadCsvRows(ServerResultsPath, ServerRows) || ServerRows.Num() == 0)
+	{
+		return TMap<FString, float>();
+	}
+
+	const TMap<FString, float>& Server = ServerRows.CreateConstIterator().Value();
+
+	TMap<FString, float> Row;
+	Row.Add(TEXT("ServerInBytesPerSecond"), Server.FindRef(TEXT("InBytesPerSecond")));
+	Row.Add(TEXT("ServerOutBytesPerSecond"), Server.FindRef(TEXT("OutBytesPerSecond")));
+	Row.Add(TEXT("ServerMsPerFrame"), Server.FindRef(TEXT("MsPerFrame")));
+	Row.Add(TEXT("ServerMaxMsPerFrame"), Server.FindRef(TEXT("MaxMsPerFrame")));
+
+	// correction rate and bandwidth are averaged over the clients, mode coverage is the worst client's
+	int32 ClientCount = 0;
+	float ModesVisited = MAX_flt;
+
+	for (const FString& ClientResultsPath : ClientResultsPaths)
+	{
+		TMap<FString, TMap<FString, float>> ClientRows;
+
+		if (!ReadCsvRows(ClientResultsPath, ClientRows) || ClientRows.Num() == 0)
+		{
+			UE_LOG(LogParkourMovement, Warning, TEXT("Missing client results %s"), *ClientResultsPath);
+			continue;
+		}
+
+		const TMap<FString, float>& Client = ClientRows.CreateConstIterator().Value();
+
+		Row.FindOrAdd(TEXT("CorrectionsPerMinute")) += Client.FindRef(TEXT("CorrectionsPerMinute"));
+		Row.FindOrAdd(TEXT("ClientInBytesPerSecond")) += Client.FindRef(TEXT("InBytesPerSecond"));
+		Row.FindOrAdd(TEXT("ClientOutBytesPerSecond")) += Client.FindRef(TEXT("OutBytesPerSecond"));
+		ModesVisited = FMath::Min(ModesVisited, Client.FindRef(TEXT("ModesVisited")));
+		ClientCount++;
+	}
+
+	if (ClientCount == 0)
+	{
+		return TMap<FString, float>();
+	}
+
+	Row[TEXT("CorrectionsPerMinute")] /= ClientCount;
+	Row[TEXT("ClientInBytesPerSecond")] /= ClientCount;
+	Row[TEXT("ClientOutBytesPerSecond")] /= ClientCount;
+	Row.Add(TEXT("ModesVisited"), ModesVisited);
+
+	return Row;
+}
+
+FString UParkourSoakCommandlet::GetAgentArgs(const FNetProfile& Profile, const FSoakSettings& Settings, const FString& ResultsPath, float WarmupSeconds)
+{
+	FString Args = FString::Printf(TEXT("-nullrhi -unattended -PktLag=%d -PktLagVariance=%d -PktLoss=%d -PktDup=%d -ParkourSoak=\"%s\" -ParkourSoakWarmup=%.1f -ParkourSoakDuration=%.1f"),
+		Profile.PktLag, Profile.PktLagVariance, Profile.PktLoss, Profile.PktDup, *ResultsPath, WarmupSeconds, Settings.DurationSeconds);
+
+	if (!Settings.ScriptPath.IsEmpty())
+	{
+		Args += FString::Printf(TEXT(" -ParkourSoakScript=\"%s\""), *FPaths::ConvertRelativePathToFull(Settings.ScriptPath));
+	}
+
+	return Args;
+}
+
+void UParkourSoakCommandlet::WaitForProcesses(TArray<FProcHandle>& Processes, double TimeoutSeconds)
+{
+	const double Deadline = FPlatformTime::Seconds() + TimeoutSeconds;
+
+	for (FProcHandle& Process : Processes)
+	{
+		while (FPlatformProcess::IsProcRunning(Process) && FPlatformTime::Seconds() < Deadline)
+		{
+			FPlatformProcess::Sleep(1.f);
+		}
+
+		if (FPlatformProcess::IsProcRunning(Process))
+		{
+			UE_LOG(LogParkourMovement, Warning, TEXT("Soak process did not exit in time, terminating it"));
+			FPlatformProcess::TerminateProc(Process, true);
+		}
+
+		FPlatformProcess::CloseProc(Process);
+	}
+}
+
+bool UParkourSoakCommandlet::ReadCsvRows(const FString& Filename, TMap<FString, TMap<FString, float>>& OutRows)
+{
+	TArray<FString> Lines;
+
+	if (!FFileHelper::LoadFileToStringArray(Lines, *Filename) || Lines.Num() < 2)
+	{
+		return false;
+	}
+
+	TArray<FString> Header;
+	Lines[0].ParseIntoArray(Header, TEXT(","), false);
+
+	TArray<FString> Cells;
+
+	for (int32 LineIndex = 1; LineIndex < Lines.Num(); LineIndex++)
+	{
+		Lines[LineIndex].ParseIntoArray(Cells, TEXT(","), false);
+
+		if (Cells.Num() != Header.Num())
+		{
+			continue;
+		}
+
+		TMap<FString, float>& Row = OutRows.Add(Cells[0]);
+
+		for (int32 i = 1; i < Cells.Num(); i++)
+		{
+			Row.Add(Header[i], FCString::Atof(*Cells[i]));
+		}
+	}
+
+	return true;
+}
@@ -0,0 +1,66 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "ParkourSoakCommandlet.generated.h"
+
+/**
+ * Network soak test on one machine. For each packet emulation profile it starts a local dedicated server and K headless clients, each
+ * running an FParkourSoakAgent that drives the client's character through every parkour mode. It then collects correction rate,
+ * bandwidth and server milliseconds per frame into one results row per profile.
+ *
+ * UE4Editor-Cmd ParkourFPS -run=ParkourSoak -map=<package> [-clients=4] [-warmup=10] [-duration=60] [-profiles=<file>] [-script=<file>]
+ *     [-port=7777] [-exe=<path>] [-out=<results.csv>] [-baseline=<results.csv>] [-threshold=<percent>]
+ *
+ * Profile files have one profile per line: "<Name> <PktLag> <PktLagVariance> <PktLoss> <PktDup>", '#' starts a comment. The values are
+ * passed as -Pkt* arguments to the server and every client, so they apply in each direction and override [PacketSimulationSettings].
+ * Returns 1 if any profile's correction rate, bandwidth or server frame time exceeds the baseline by more than the threshold (10% by default).
+ */
+UCLASS()
+class PARKOURFPS_API UParkourSoakCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UParkourSoakCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+
+private:
+	struct FNetProfile
+	{
+		FString Name;
+		int32 PktLag = 0;
+		int32 PktLagVariance = 0;
+		int32 PktLoss = 0;
+		int32 PktDup = 0;
+	};
+
+	struct FSoakSettings
+	{
+		FString Executable;
+		FString MapName;
+		FString ScriptPath;
+		FString ResultsDir;
+		int32 Clients = 4;
+		int32 Port = 7777;
+		float WarmupSeconds = 10.f;
+		float DurationSeconds = 60.f;
+	};
+
+	static TArray<FNetProfile> MakeDefaultProfiles();
+
+	static bool LoadProfiles(const FString& Filename, TArray<FNetProfile>& OutProfiles);
+
+	// Runs the server and clients for one profile and returns the aggregated results row, empty if the server or every client failed
+	static TMap<FString, float> RunProfile(const FNetProfile& Profile, const FSoakSettings& Settings);
+
+	static FString GetAgentArgs(const FNetProfile& Profile, const FSoakSettings& Settings, const FString& ResultsPath, float WarmupSeconds);
+
+	static void WaitForProcesses(TArray<FProcHandle>& Processes, double TimeoutSeconds);
+
+	// Reads the header and row written by an FParkourSoakAgent or a previous results file, keyed by the first column when there are several rows
+	static bool ReadCsvRows(const FString& Filename, TMap<FString, TMap<FString, float>>& OutRows);
+};
@@ -0,0 +1,114 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ParkourTrace.h"
+#include "GameFramework/Actor.h"
+#include "HAL/PlatformTime.h"
+
+#if PARKOUR_TRACE_ENABLED
+
+UE_TRACE_CHANNEL_DEFINE(ParkourChannel)
+
+UE_TRACE_EVENT_BEGIN(Parkour, ModeChange)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint32, ActorId)
+	UE_TRACE_EVENT_FIELD(uint8, PreviousMode)
+	UE_TRACE_EVENT_FIELD(uint8, PreviousCustomMode)
+	UE_TRACE_EVENT_FIELD(uint8, NewMode)
+	UE_TRACE_EVENT_FIELD(uint8, NewCustomMode)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(Parkour, Action)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint32, ActorId)
+	UE_TRACE_EVENT_FIELD(uint8, Action)
+	UE_TRACE_EVENT_FIELD(bool, Begin)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(Parkour, Probe)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint32, ActorId)
+	UE_TRACE_EVENT_FIELD(uint8, Probe)
+	UE_TRACE_EVENT_FIELD(bool, Hit)
+	UE_TRACE_EVENT_FIELD(uint32, ElapsedCycles)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(Parkour, CustomJump)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint32, ActorId)
+	UE_TRACE_EVENT_FIELD(uint8, CustomMode)
+	UE_TRACE_EVENT_FIELD(float, LaunchX)
+	UE_TRACE_EVENT_FIELD(float, LaunchY)
+	UE_TRACE_EVENT_FIELD(float, LaunchZ)
+UE_TRACE_EVENT_END()
+
+namespace
+{
+	uint32 GetTraceActorId(const AActor* Actor)
+	{
+		return Actor != nullptr ? Actor->GetUniqueID() : 0;
+	}
+}
+
+void FParkourTrace::OutputModeChange(const AActor* Actor, uint8 PreviousMode, uint8 PreviousCustomMode, uint8 NewMode, uint8 NewCustomMode)
+{
+	UE_TRACE_LOG(Parkour, ModeChange, ParkourChannel)
+		<< ModeChange.Cycle(FPlatformTime::Cycles64())
+		<< ModeChange.ActorId(GetTraceActorId(Actor))
+		<< ModeChange.PreviousMode(PreviousMode)
+		<< ModeChange.PreviousCustomMode(PreviousCustomMode)
+		<< ModeChange.NewMode(NewMode)
+		<< ModeChange.NewCustomMode(NewCustomMode);
+}
+
+void FParkourTrace::OutputAction(const AActor* Actor, EParkourAction ParkourAction, bool bBegin)
+{
+	UE_TRACE_LOG(Parkour, Action, ParkourChannel)
+		<< Action.Cycle(FPlatformTime::Cycles64())
+		<< Action.ActorId(GetTraceActorId(Actor))
+		<< Action.Action(static_cast<uint8>(ParkourAction))
+		<< Action.Begin(bBegin);
+}
+
+void FParkourTrace::OutputProbe(const AActor* Actor, EParkourProbe ParkourProbe, bool bHit, uint64 Cycles)
+{
+	UE_TRACE_LOG(Parkour, Probe, ParkourChannel)
+		<< Probe.Cycle(FPlatformTime::Cycles64())
+		<< Probe.ActorId(GetTraceActorId(Actor))
+		<< Probe.Probe(static_cast<uint8>(ParkourProbe))
+		<< Probe.Hit(bHit)
+		<< Probe.ElapsedCycles(static_cast<uint32>(FMath::Min<uint64>(Cycles, MAX_uint32)));
+}
+
+void FParkourTrace::OutputCustomJump(const AActor* Actor, uint8 CustomMode, const FVector& LaunchVelocity)
+{
+	UE_TRACE_LOG(Parkour, CustomJump, ParkourChannel)
+		<< CustomJump.Cycle(FPlatformTime::Cycles64())
+		<< CustomJump.ActorId(GetTraceActorId(Actor))
+		<< CustomJump.CustomMode(CustomMode)
+		<< CustomJump.LaunchX(LaunchVelocity.X)
+		<< CustomJump.LaunchY(LaunchVelocity.Y)
+		<< CustomJump.LaunchZ(LaunchVelocity.Z);
+}
+
+FParkourProbeTraceScope::FParkourProbeTraceScope(const AActor* InActor, EParkourProbe InProbe)
+	: Actor(InActor)
+	, Probe(InProbe)
+	, StartCycles(0)
+{
+	// Only pay for the timer read when someone is actually recording the channel
+	if (UE_TRACE_CHANNELEXPR_IS_ENABLED(ParkourChannel))
+	{
+		StartCycles = FPlatformTime::Cycles64();
+	}
+}
+
+FParkourProbeTraceScope::~FParkourProbeTraceScope()
+{
+	if (StartCycles != 0)
+	{
+		FParkourTrace::OutputProbe(Actor, Probe, bHit, FPlatformTime::Cycles64() - StartCycles);
+	}
+}
+
+#endif
@@ -0,0 +1,88 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Trace/Trace.h"
+
+class AActor;
+
+// Binary trace events for Unreal Insights. Enable with "-trace=cpu,parkour" to line parkour
+// mode transitions and probe results up against the game thread timeline.
+#define PARKOUR_TRACE_ENABLED (UE_TRACE_ENABLED && !UE_BUILD_SHIPPING)
+
+// Probes that report their outcome to the parkour trace channel
+enum class EParkourProbe : uint8
+{
+	IsNextToWall,
+	CheckWallRunTraces,
+	CheckCanWallRun,
+	CheckCanVerticalWallRun,
+	CheckCanHangLedge,
+	CheckCanClimb,
+	CheckCanQuickClimb,
+	CheckCanVault,
+	CheckCanZipline,
+	CheckCanClimbLadder,
+};
+
+// Parkour actions that are started and stopped by the Begin*/End* functions
+enum class EParkourAction : uint8
+{
+	WallRun,
+	VerticalWallRun,
+	Slide,
+	Zipline,
+	ClimbLadder,
+	LedgeHang,
+	ClimbLedge,
+};
+
+#if PARKOUR_TRACE_ENABLED
+
+UE_TRACE_CHANNEL_EXTERN(ParkourChannel, PARKOURFPS_API)
+
+struct PARKOURFPS_API FParkourTrace
+{
+	static void OutputModeChange(const AActor* Actor, uint8 PreviousMode, uint8 PreviousCustomMode, uint8 NewMode, uint8 NewCustomMode);
+	static void OutputAction(const AActor* Actor, EParkourAction ParkourAction, bool bBegin);
+	static void OutputProbe(const AActor* Actor, EParkourProbe ParkourProbe, bool bHit, uint64 Cycles);
+	static void OutputCustomJump(const AActor* Actor, uint8 CustomMode, const FVector& LaunchVelocity);
+};
+
+// Times a probe and reports whether it passed once the scope ends
+struct PARKOURFPS_API FParkourProbeTraceScope
+{
+	FParkourProbeTraceScope(const AActor* InActor, EParkourProbe InProbe);
+	~FParkourProbeTraceScope();
+
+	const AActor* Actor;
+	EParkourProbe Probe;
+	uint64 StartCycles;
+	bool bHit = false;
+};
+
+#define PARKOUR_TRACE_MODE_CHANGE(Actor, PreviousMode, PreviousCustomMode, NewMode, NewCustomMode) \
+	FParkourTrace::OutputModeChange(Actor, PreviousMode, PreviousCustomMode, NewMode, NewCustomMode)
+
+#define PARKOUR_TRACE_ACTION(Actor, Action, bBegin) \
+	FParkourTrace::OutputAction(Actor, Action, bBegin)
+
+#define PARKOUR_TRACE_CUSTOM_JUMP(Actor, CustomMode, LaunchVelocity) \
+	FParkourTrace::OutputCustomJump(Actor, CustomMode, LaunchVelocity)
+
+#define PARKOUR_TRACE_PROBE_SCOPE(Actor, Probe) \
+	FParkourProbeTraceScope ParkourProbeTraceScope(Actor, Probe)
+
+#define PARKOUR_TRACE_PROBE_HIT() \
+	ParkourProbeTraceScope.bHit = true
+
+#else
+
+#define PARKOUR_TRACE_MODE_CHANGE(...)
+#define PARKOUR_TRACE_ACTION(...)
+#define PARKOUR_TRACE_CUSTOM_JUMP(...)
+#define PARKOUR_TRACE_PROBE_SCOPE(...)
+#define PARKOUR_TRACE_PROBE_HIT()
+
+#endif